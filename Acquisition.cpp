@@ -0,0 +1,1171 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "Acquisition.h"
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <future>
+#include <algorithm>
+
+// Including for Emotiv
+#include "IedkErrorCode.h"
+
+// Including for LabStreamingLayer
+#include "lsl_cpp.h"
+
+// Including of own code
+#include "Config.h"
+#include "SampleBlock.h"
+#include "DeviceProfile.h"
+#include "EEGChain.h"
+#include "SampleRing.h"
+#include "EEGPublisher.h"
+#include "SampleSubscriber.h"
+#include "Realtime.h"
+#include "Hyperscanning.h"
+#include "ConsumerGate.h"
+#include "EngineSupervisor.h"
+#include "ClockEstimator.h"
+#include "Diagnostics.h"
+#include "Watchdog.h"
+#include "MemoryBounds.h"
+#include "EngineBackend.h"
+#include "EngineTrace.h"
+#include "RollingStatistics.h"
+#include "BufferTuner.h"
+#include "WorkStealingPool.h"
+
+// Defines
+const double bufferInSeconds = 2.0; // default initial and minimal size in seconds of SDK buffers for EEG and motion data
+const long long sleepDurationInMiliseconds = 50; 
+const unsigned int maxPendingEmoStates = 32; // intermediate EmoStates kept per iteration, further ones are coalesced
+const int defaultSampleRateMotion = 64; // used when device does not report its motion sample rate
+const size_t eegRingSlotCount = 16; // EEG blocks buffered between acquisition and publishing
+const size_t prefaultStackInBytes = 256 * 1024; // stack touched at startup when memory is locked
+const int defaultPipelineThreads = 2; // workers running derived EEG streams, shared by all acquisitions of the process
+
+// Whether an acquisition of the process is running, as they would share the EmoEngine and the names of outlets
+static std::atomic<bool> acquisitionRunning{ false };
+
+// List of motion channels
+IEE_MotionDataChannel_t motionChannelList[] =
+{
+	IMD_GYROX,
+	IMD_GYROY,
+	IMD_GYROZ,
+	IMD_ACCX,
+	IMD_ACCY,
+	IMD_ACCZ,
+	IMD_MAGX,
+	IMD_MAGY,
+	IMD_MAGZ,
+};
+
+// Corresponding motion channel labels and types
+const std::vector<std::pair<std::string, std::string> > motionChannelLabels =
+{
+	{ "GYROX", "Gyroscope" },
+	{ "GYROY", "Gyroscope" },
+	{ "GYROZ", "Gyroscope" },
+	{ "ACCX", "Accelerometer" },
+	{ "ACCY", "Accelerometer" },
+	{ "ACCZ", "Accelerometer" },
+	{ "MAGX", "Magnetometer" },
+	{ "MAGY", "Magnetometer" },
+	{ "MAGZ", "Magnetometer" },
+};
+
+// Facial expression labels
+const std::vector<std::string> facialExpressionLabels
+{
+	"BLINK",
+	"WINK_LEFT",
+	"WINK_RIGHT",
+	// "HORIEYE",
+	"SURPRISE",
+	"FROWN",
+	"CLENCH",
+	"SMILE",
+	//"LAUGH",
+	//"SMIRK_LEFT",
+	//"SMIRK_RIGHT",
+	"NEUTRAL"
+};
+
+// Performance metrics labels
+const std::vector<std::string> performanceMetricsLabels
+{
+	// Stress
+	"STRESS_RAW_SCORE",
+	"STRESS_MIN_SCORE",
+	"STRESS_MAX_SCORE",
+	"STRESS_SCALED_SCORE",
+
+	// Boredom
+	"ENGAGEMENT_BOREDOM_RAW_SCORE",
+	"ENGAGEMENT_BOREDOM_MIN_SCORE",
+	"ENGAGEMENT_BOREDOM_MAX_SCORE",
+	"ENGAGEMENT_BOREDOM_SCALED_SCORE",
+
+	// Relaxation
+	"RELAXATION_RAW_SCORE",
+	"RELAXATION_MIN_SCORE",
+	"RELAXATION_MAX_SCORE",
+	"RELAXATION_SCALED_SCORE",
+
+	// Excitement
+	"EXCITEMENT_RAW_SCORE",
+	"EXCITEMENT_MIN_SCORE",
+	"EXCITEMENT_MAX_SCORE",
+	"EXCITEMENT_SCALED_SCORE",
+
+	// Interest
+	"INTEREST_RAW_SCORE",
+	"INTEREST_MIN_SCORE",
+	"INTEREST_MAX_SCORE",
+	"INTEREST_SCALED_SCORE",
+
+	// Raw scores normalized over rolling window, as standard score and between minimum and maximum
+	"STRESS_Z_SCORE",
+	"STRESS_WINDOW_SCALED_SCORE",
+	"ENGAGEMENT_BOREDOM_Z_SCORE",
+	"ENGAGEMENT_BOREDOM_WINDOW_SCALED_SCORE",
+	"RELAXATION_Z_SCORE",
+	"RELAXATION_WINDOW_SCALED_SCORE",
+	"EXCITEMENT_Z_SCORE",
+	"EXCITEMENT_WINDOW_SCALED_SCORE",
+	"INTEREST_Z_SCORE",
+	"INTEREST_WINDOW_SCALED_SCORE"
+};
+
+// Extract motion channel count
+unsigned int motionChannelCount = sizeof(motionChannelList) / sizeof(IEE_MotionDataChannel_t);
+
+// Forward declaration
+lsl::stream_info CreateMotionStreamInfo(double sampleRate);
+lsl::stream_info CreateFacialExpressionStreamInfo();
+lsl::stream_info CreatePerformanceMetricsStreamInfo();
+std::future<std::unique_ptr<lsl::stream_outlet> > CreateOutletAsync(const lsl::stream_info& rInfo, const Config& rConfig);
+std::unique_ptr<EngineBackend> CreateEngineBackend(const Config& rConfig);
+void PushFacialExpression(lsl::stream_outlet& rOutlet, const EmoStateSnapshot& rState, double timestamp);
+void PushPerformanceMetrics(lsl::stream_outlet& rOutlet, const EmoStateSnapshot& rState, std::vector<RollingStatistics>& rStatistics, double timestamp);
+void CaculateScale(double& rawScore, double& maxScale, double& minScale, double& scaledScore);
+
+Acquisition::Acquisition(const Config& rConfig) : mConfig(rConfig)
+{
+}
+
+Acquisition::~Acquisition()
+{
+	Stop();
+}
+
+void Acquisition::SetSampleCallback(AcquisitionStream stream, SampleCallback callback)
+{
+	mSampleCallbacks[stream] = callback;
+}
+
+bool Acquisition::Start()
+{
+	if (mRunning.load())
+	{
+		return false;
+	}
+
+	// Thread of previous run may have ended on its own
+	if (mThread.joinable())
+	{
+		mThread.join();
+	}
+
+	// Claimed until thread ends
+	bool otherRunning = false;
+	if (!acquisitionRunning.compare_exchange_strong(otherRunning, true))
+	{
+		return false;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStatistics = AcquisitionStatistics();
+		mError.clear();
+	}
+	mStartTime = lsl::local_clock();
+	mRunning = true;
+	try
+	{
+		mThread = std::thread(&Acquisition::Run, this);
+	}
+	catch (...)
+	{
+		mRunning = false;
+		acquisitionRunning = false;
+		throw;
+	}
+	return true;
+}
+
+void Acquisition::Stop()
+{
+	mRunning = false;
+	if (mThread.joinable())
+	{
+		mThread.join();
+	}
+}
+
+AcquisitionStatistics Acquisition::GetStatistics() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mStatistics;
+}
+
+std::string Acquisition::GetError() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mError;
+}
+
+void Acquisition::Run()
+{
+	// State of acquisition
+	bool readyToCollect = false; // indicator whether data collection can begin
+	int error = 0; // storage for error code
+	unsigned int userID = 0; // id of primary user, whose headset feeds the main streams
+
+	// Backend of the EmoEngine outlives everything acquiring from it
+	std::unique_ptr<EngineBackend> upEngine;
+
+	// Try to connect and send data to LabStreamingLayer
+	try
+	{
+		// Time to first sample is measured from start
+		double startTime = mStartTime;
+
+		// EmoEngine itself or a replayed trace, calls may be recorded
+		upEngine = CreateEngineBackend(mConfig);
+		EngineBackend& rEngine = *upEngine;
+
+		// Connect to EmoEngine on a worker thread and describe the streams meanwhile
+		std::future<int> futureConnect = std::async(std::launch::async, [&rEngine]() { return rEngine.Connect(); });
+		std::future<lsl::stream_info> futureInfoFacialExpression = std::async(std::launch::async, CreateFacialExpressionStreamInfo);
+		std::future<lsl::stream_info> futureInfoPerformanceMetrics = std::async(std::launch::async, CreatePerformanceMetricsStreamInfo);
+
+		// ##############################
+		// ### EEG STREAM PREPARATION ###
+		// ##############################
+
+		// Derived EEG streams are processed on a pool, or after publishing the main stream when there are no threads
+		std::shared_ptr<WorkStealingPool> spPipelinePool;
+		int pipelineThreads = mConfig.GetInt("pipelineThreads", defaultPipelineThreads);
+		if (pipelineThreads > 0)
+		{
+			spPipelinePool = GetSharedWorkStealingPool((unsigned int)pipelineThreads);
+		}
+
+		// Outlets and stages of EEG are created when the user is added and the device is known
+		std::shared_ptr<EEGChain> spEEGChain;
+		std::string deviceProfile = mConfig.GetString("deviceProfile", "auto");
+
+		// Data stream which holds the buffer
+		unsigned int eegStream = rEngine.CreateStream(ENGINE_STREAM_EEG);
+
+		// Reusable buffer for fetched data
+		std::vector<double> channelData; // channel after channel, as filled by Emotiv
+
+		// Size of SDK buffers follows the count of samples per update
+		BufferTuner bufferTuner(mConfig.GetDouble("bufferSize", bufferInSeconds), mConfig.GetDouble("bufferSizeMin", bufferInSeconds), mConfig.GetDouble("bufferSizeMax", 8.0));
+
+		// Blocks are handed to a publishing thread. Slots hold a full SDK buffer of the largest profile and size
+		unsigned int maxBufferedSamples = (unsigned int)(bufferTuner.GetMaxSize() * EpocPlus256Profile::sampleRate);
+		SampleRing eegRing(eegRingSlotCount, EpocPlus256Profile::channelCount, maxBufferedSamples);
+
+		// Behavior when publishing falls behind. While acquisition waits for publishing, the SDK buffers the samples
+		std::string ringPolicyName = mConfig.GetString("ringPolicy", "dropNewest");
+		RingPolicy ringPolicy = RING_DROP_NEWEST;
+		if (ringPolicyName == "dropOldest")
+		{
+			ringPolicy = RING_DROP_OLDEST;
+		}
+		else if (ringPolicyName == "block")
+		{
+			ringPolicy = RING_BLOCK;
+		}
+		else if (ringPolicyName != "dropNewest")
+		{
+			throw std::runtime_error("Unknown ring policy: " + ringPolicyName);
+		}
+		std::chrono::microseconds ringBlockWait((long long)(mConfig.GetDouble("ringBlockTimeout", 0.025) * 1e6));
+
+		// ##########################
+		// ### REAL-TIME SETTINGS ###
+		// ##########################
+
+		// Lock memory and fault in buffers and stack before any thread works on them
+		if (mConfig.GetBool("lockMemory", false))
+		{
+			channelData.resize((size_t)EpocPlus256Profile::channelCount * maxBufferedSamples);
+			eegRing.Prefault();
+			PrefaultStack(prefaultStackInBytes);
+			std::cout << (LockMemory() ? "Memory locked" : "Memory could not be locked") << std::endl;
+		}
+
+		// ################
+		// ### WATCHDOG ###
+		// ################
+
+		// Stalls of acquisition and publishing are pushed as alarms. EEG samples are
+		// expected within the loop period plus the duration of a count of samples
+		Watchdog watchdog(mConfig.GetDouble("watchdogTimeout", 0.3), mConfig);
+		double watchdogMissingSamples = mConfig.GetDouble("watchdogMissingSamples", 32.0);
+
+		// Publishing thread gets one priority level below acquisition, so acquisition wins
+		EEGPublisher eegPublisher(eegRing, ringPolicy, &watchdog);
+
+		// Host views blocks in place on a thread of its own, publishing is not held back by it
+		std::unique_ptr<SampleSubscriber> upEEGSubscriber;
+		if (mSampleCallbacks[ACQUISITION_STREAM_EEG])
+		{
+			upEEGSubscriber = std::unique_ptr<SampleSubscriber>(new SampleSubscriber(eegRing, mSampleCallbacks[ACQUISITION_STREAM_EEG]));
+		}
+		int realtimePriority = mConfig.GetInt("realtimePriority", 0);
+		if (realtimePriority > 0)
+		{
+			bool prioritized = SetThreadRealtimePriority(CurrentThreadHandle(), realtimePriority);
+			prioritized &= SetThreadRealtimePriority(eegPublisher.GetNativeHandle(), realtimePriority > 1 ? realtimePriority - 1 : 1);
+			std::cout << (prioritized ? "Real-time priority set" : "Real-time priority could not be set") << std::endl;
+		}
+		int acquisitionCpu = mConfig.GetInt("acquisitionCpu", -1);
+		if (acquisitionCpu >= 0 && !SetThreadAffinity(CurrentThreadHandle(), acquisitionCpu))
+		{
+			std::cout << "Acquisition could not be pinned to CPU " << acquisitionCpu << std::endl;
+		}
+		int publisherCpu = mConfig.GetInt("publisherCpu", -1);
+		if (publisherCpu >= 0 && !SetThreadAffinity(eegPublisher.GetNativeHandle(), publisherCpu))
+		{
+			std::cout << "Publishing could not be pinned to CPU " << publisherCpu << std::endl;
+		}
+
+		// #################################
+		// ### MOTION STREAM PREPARATION ###
+		// #################################
+
+		// Outlet is created when the user is added and the device has told its motion sample rate
+		bool motionEnabled = mConfig.GetBool("motion", true);
+		std::unique_ptr<lsl::stream_outlet> upOutletMotion;
+		double sampleRateMotion = defaultSampleRateMotion;
+
+		// Data stream which holds the buffer
+		unsigned int motionStream = rEngine.CreateStream(ENGINE_STREAM_MOTION);
+
+		// Reusable buffers for fetched data
+		std::vector<double> motionChannelData;
+		std::vector<double*> motionChannelPointers(motionChannelCount);
+		SampleBlock motionBlock;
+
+		// ##############################################
+		// ### EMO STATE DEPENDENT STREAM PREPARATION ###
+		// ##############################################
+
+		// Outlets are created when the user is added, from information prepared at startup
+		lsl::stream_info streamInfoFacialExpression = futureInfoFacialExpression.get();
+		lsl::stream_info streamInfoPerformanceMetrics = futureInfoPerformanceMetrics.get();
+		std::unique_ptr<lsl::stream_outlet> upOutletFacialExpression;
+		std::unique_ptr<lsl::stream_outlet> upOutletPerformanceMetrics;
+
+		// Raw scores of performance metrics are normalized over their recent history
+		std::vector<RollingStatistics> performanceMetricsStatistics(PERFORMANCE_METRIC_COUNT, RollingStatistics(mConfig.GetDouble("performanceMetricsWindow", 60.0)));
+
+		// Time to first sample is told once
+		bool firstSamplePublished = false;
+
+		// ##############################
+		// ### CONNECTION SUPERVISION ###
+		// ##############################
+
+		// Supervisor keeps reconnecting to the EmoEngine. Buffer sizes are set after each connection
+		EngineSupervisor supervisor(rEngine, mConfig);
+		supervisor.SetConnectedCallback([&rEngine, &bufferTuner]()
+		{
+			rEngine.SetBufferSize((float)bufferTuner.GetSize());
+		});
+
+		// #########################
+		// ### CLOCK DIAGNOSTICS ###
+		// #########################
+
+		// Clock model of EEG over rolling window, published on diagnostics stream
+		double clockWindow = mConfig.GetDouble("clockWindow", 60.0);
+		ClockEstimator clockEstimator((unsigned int)(clockWindow * 1000.0 / sleepDurationInMiliseconds));
+		Diagnostics diagnostics(mConfig.GetDouble("diagnosticsInterval", 1.0), mConfig);
+		double eegSampleIndex = 0.0; // count of EEG samples since user has been added
+
+		// #####################
+		// ### HYPERSCANNING ###
+		// #####################
+
+		// Aggregate of several headsets is created with the first one, as its device defines the channels
+		unsigned int hyperscanningHeadsets = (unsigned int)std::max(mConfig.GetInt("hyperscanningHeadsets", 0), 0);
+		double hyperscanningMaxLatency = mConfig.GetDouble("hyperscanningMaxLatency", 0.5);
+		std::unique_ptr<HyperscanAggregator> upHyperscanAggregator;
+
+		// Check connection, failure is retried in the main loop
+		bool connected = futureConnect.get() == EDK_OK;
+		supervisor.ReportConnectResult(connected, lsl::local_clock());
+		if (connected)
+		{
+			std::cout << "EmoEngine connected after " << (int)((lsl::local_clock() - startTime) * 1000.0) << " ms" << std::endl;
+		}
+
+		// #######################
+		// ### ENTER MAIN LOOP ###
+		// #######################
+
+		// Pool of EmoStates received during one iteration, only first one is used when coalescing
+		std::vector<EmoStateSnapshot> pendingStates(1);
+		unsigned int pendingStateCount = 0;
+		bool emitIntermediateEmoStates = mConfig.GetBool("emitIntermediateEmoStates", false);
+
+		// Outlets are only fed while they have consumers
+		ConsumerGate gateFacialExpression;
+		ConsumerGate gatePerformanceMetrics;
+		ConsumerGate gateMotion;
+
+		// Statistics about event handling
+		unsigned long long eventsDrained = 0;
+		unsigned long long emoStatesCoalesced = 0;
+
+		// Iterations start at fixed deadlines, lateness of wakeups is measured
+		DeadlineTimer loopTimer(sleepDurationInMiliseconds);
+		double maxWakeupLateness = 0.0;
+		unsigned long long missedDeadlines = 0;
+
+		// Memory footprint is measured once per diagnostics sample
+		size_t residentMemory = GetResidentMemory();
+		size_t peakResidentMemory = residentMemory;
+
+		// Send information until stopped
+		watchdog.Arm(WATCHDOG_ACQUISITION, lsl::local_clock());
+		while (mRunning.load())
+		{
+			// Nothing to do until connected to the EmoEngine
+			double tickTime = lsl::local_clock();
+			watchdog.Beat(WATCHDOG_ACQUISITION, tickTime);
+			if (!supervisor.Update(tickTime))
+			{
+				loopTimer.Wait();
+				continue;
+			}
+
+			// ##################
+			// ### EVENT PUMP ###
+			// ##################
+
+			// EmoStates are only of interest when one of their outlets has consumers
+			bool facialExpressionOpen = upOutletFacialExpression && gateFacialExpression.Update(*upOutletFacialExpression, tickTime);
+			bool performanceMetricsOpen = upOutletPerformanceMetrics && gatePerformanceMetrics.Update(*upOutletPerformanceMetrics, tickTime);
+
+			// Drain all events queued since last iteration, so the backlog does not add latency
+			pendingStateCount = 0;
+
+			// Each call for the next event is watched, not the handling of the event
+			EngineEvent event;
+			watchdog.Arm(WATCHDOG_EVENT_PUMP, lsl::local_clock());
+			while ((error = rEngine.GetNextEvent(event)) == EDK_OK) // fills event
+			{
+				watchdog.Disarm(WATCHDOG_EVENT_PUMP, lsl::local_clock());
+				eventsDrained++;
+
+				// React to event
+				switch (event.type)
+				{
+				case IEE_UserAdded: // event tells about added user
+					// First user added is the primary one, who feeds the main streams. Further headsets only take part in hyperscanning
+					if (readyToCollect && event.userID != userID)
+					{
+						if (upHyperscanAggregator)
+						{
+							upHyperscanAggregator->AddUser(event.userID, SelectDevice(rEngine, event.userID, deviceProfile));
+						}
+						std::cout << "Further User Added" << std::endl;
+						break;
+					}
+					userID = event.userID;
+					rEngine.EnableAcquisition(userID);
+					readyToCollect = true;
+					for (RollingStatistics& rStatistics : performanceMetricsStatistics)
+					{
+						rStatistics.Reset();
+					}
+					supervisor.ReportUserAdded(lsl::local_clock());
+					clockEstimator.Reset();
+					eegSampleIndex = 0.0;
+					std::cout << "User Successfully Added" << std::endl;
+
+					// Create outlets missing so far. Each outlet sets up its own sockets and
+					// threads, so they are created in parallel rather than one after another.
+					// Creation may take longer than the watchdog allows for an iteration
+					{
+						double creationStartTime = lsl::local_clock();
+						watchdog.Disarm(WATCHDOG_ACQUISITION, creationStartTime);
+
+						// EEG outlets for device, kept as long as the same device is used
+						const DeviceDescriptor& rDevice = SelectDevice(rEngine, userID, deviceProfile);
+						std::future<std::unique_ptr<EEGChain> > futureEEGChain;
+						if (!spEEGChain || &spEEGChain->GetDevice() != &rDevice)
+						{
+							eegPublisher.SetChain(nullptr);
+							spEEGChain.reset();
+							futureEEGChain = std::async(std::launch::async, [&rDevice, spPipelinePool, this]() { return std::unique_ptr<EEGChain>(new EEGChain(rDevice, mConfig, spPipelinePool)); });
+						}
+
+						// Motion outlet with sample rate of device
+						std::future<std::unique_ptr<lsl::stream_outlet> > futureOutletMotion;
+						if (motionEnabled && !upOutletMotion)
+						{
+							unsigned int reportedRate = 0;
+							if (rEngine.GetMotionSampleRate(userID, reportedRate) == EDK_OK && reportedRate > 0)
+							{
+								sampleRateMotion = reportedRate;
+							}
+							futureOutletMotion = CreateOutletAsync(CreateMotionStreamInfo(sampleRateMotion), mConfig);
+						}
+
+						// Outlets of EmoState dependent streams
+						std::future<std::unique_ptr<lsl::stream_outlet> > futureOutletFacialExpression;
+						std::future<std::unique_ptr<lsl::stream_outlet> > futureOutletPerformanceMetrics;
+						if (!upOutletFacialExpression)
+						{
+							futureOutletFacialExpression = CreateOutletAsync(streamInfoFacialExpression, mConfig);
+						}
+						if (!upOutletPerformanceMetrics)
+						{
+							futureOutletPerformanceMetrics = CreateOutletAsync(streamInfoPerformanceMetrics, mConfig);
+						}
+
+						// Collect created outlets
+						if (futureEEGChain.valid())
+						{
+							spEEGChain = futureEEGChain.get();
+							eegPublisher.SetChain(spEEGChain);
+							std::cout << "EEG streams created for " << rDevice.name << " with " << rDevice.sampleRate << " Hz" << std::endl;
+						}
+						if (futureOutletMotion.valid())
+						{
+							upOutletMotion = futureOutletMotion.get();
+							std::cout << "Motion stream created with " << sampleRateMotion << " Hz" << std::endl;
+						}
+						if (futureOutletFacialExpression.valid())
+						{
+							upOutletFacialExpression = futureOutletFacialExpression.get();
+						}
+						if (futureOutletPerformanceMetrics.valid())
+						{
+							upOutletPerformanceMetrics = futureOutletPerformanceMetrics.get();
+						}
+						std::cout << "Outlets ready after " << (int)((lsl::local_clock() - creationStartTime) * 1000.0) << " ms" << std::endl;
+
+						// Samples are expected from now on
+						double creationEndTime = lsl::local_clock();
+						watchdog.Arm(WATCHDOG_ACQUISITION, creationEndTime);
+						watchdog.Arm(WATCHDOG_EEG_SAMPLES, creationEndTime, sleepDurationInMiliseconds / 1000.0 + watchdogMissingSamples / rDevice.sampleRate);
+
+						// Primary user participates in hyperscanning as well
+						if (hyperscanningHeadsets > 0)
+						{
+							if (!upHyperscanAggregator)
+							{
+								upHyperscanAggregator = std::unique_ptr<HyperscanAggregator>(new HyperscanAggregator(
+									rEngine, rDevice, hyperscanningHeadsets, hyperscanningMaxLatency, (unsigned int)(clockWindow * 1000.0 / sleepDurationInMiliseconds), mConfig));
+							}
+							upHyperscanAggregator->AddUser(userID, rDevice);
+						}
+					}
+					break;
+
+				case IEE_UserRemoved: // event tells about removed user
+					if (upHyperscanAggregator)
+					{
+						upHyperscanAggregator->RemoveUser(event.userID);
+					}
+
+					std::cout << "User Removed" << std::endl;
+
+					// Main streams go on while the primary user is present
+					if (!readyToCollect || event.userID != userID)
+					{
+						break;
+					}
+					readyToCollect = false;
+					watchdog.Disarm(WATCHDOG_EEG_SAMPLES, lsl::local_clock());
+					supervisor.ReportUserRemoved(lsl::local_clock());
+					break;
+
+				case IEE_EmoStateUpdated: // event tells about updated emo state
+					if (!facialExpressionOpen && !performanceMetricsOpen)
+					{
+						break;
+					}
+
+					// Newer state replaces the last pending one
+					bool coalesce = pendingStateCount > 0 && (!emitIntermediateEmoStates || pendingStateCount >= maxPendingEmoStates);
+					size_t stateIdx = coalesce ? pendingStateCount - 1 : pendingStateCount;
+					if (stateIdx == pendingStates.size())
+					{
+						pendingStates.push_back(EmoStateSnapshot());
+					}
+
+					// EmoState is only read now that somebody consumes it, a failed read leaves the pending ones
+					if (rEngine.ReadEmoState(pendingStates[stateIdx]) != EDK_OK)
+					{
+						break;
+					}
+					if (coalesce)
+					{
+						emoStatesCoalesced++;
+					}
+					else
+					{
+						pendingStateCount++;
+					}
+					break;
+				}
+				watchdog.Arm(WATCHDOG_EVENT_PUMP, lsl::local_clock());
+			}
+			watchdog.Disarm(WATCHDOG_EVENT_PUMP, lsl::local_clock());
+
+			// Anything but an empty queue means the connection to the EmoEngine broke. Outlets
+			// are kept, acquisition is enabled again when the user is added after reconnection
+			if (error != EDK_NO_EVENT)
+			{
+				supervisor.ReportEngineFailure(error, lsl::local_clock());
+				readyToCollect = false;
+				watchdog.Disarm(WATCHDOG_EEG_SAMPLES, lsl::local_clock());
+				if (upHyperscanAggregator)
+				{
+					upHyperscanAggregator->RemoveAllUsers();
+				}
+			}
+
+			// Since it is ready to collect, do it
+			if (readyToCollect)
+			{
+				// ############################
+				// ### EEG STREAM EXECUTION ###
+				// ############################
+
+				// Update data streams together, so their samples are stamped by the same clock reading.
+				// Handles are updated even without consumers, which discards samples nobody wants
+				watchdog.Arm(WATCHDOG_DATA_UPDATE, lsl::local_clock());
+				rEngine.UpdateStream(eegStream, userID); // update data stream
+				if (upOutletMotion)
+				{
+					rEngine.UpdateStream(motionStream, userID); // update motion stream
+				}
+				double fetchTime = lsl::local_clock();
+				watchdog.Disarm(WATCHDOG_DATA_UPDATE, fetchTime);
+
+				// Fetch samples with acquisition specialized for the device into a free slot of the
+				// ring, if anybody listens. Without free slot the samples are dropped and counted
+				unsigned int sampleCount = 0;
+				if ((spEEGChain->UpdateConsumers(fetchTime) || mSampleCallbacks[ACQUISITION_STREAM_EEG]) && (ringPolicy == RING_BLOCK ? eegRing.Reserve(1, ringBlockWait) : eegRing.Reserve(1)) == 1)
+				{
+					sampleCount = spEEGChain->GetDevice().acquire(rEngine, eegStream, channelData, eegRing.Reserved(0), fetchTime);
+					std::cout << "EEG Sample Count: " << std::to_string(sampleCount) << std::endl;
+
+					// Hand samples over to publishing
+					if (sampleCount != 0)
+					{
+						eegRing.Commit(1);
+					}
+				}
+				else
+				{
+					sampleCount = rEngine.GetSampleCount(eegStream);
+				}
+
+				// Tell once when first samples have left
+				if (!firstSamplePublished && eegPublisher.GetPublishedBlockCount() > 0)
+				{
+					std::cout << "Time to first sample: " << (int)((lsl::local_clock() - startTime) * 1000.0) << " ms" << std::endl;
+					firstSamplePublished = true;
+				}
+
+				// Resize SDK buffers right after they have been emptied, when they were nearly full or stay rather empty
+				if (bufferTuner.Add(sampleCount, spEEGChain->GetDevice().sampleRate, fetchTime))
+				{
+					rEngine.SetBufferSize((float)bufferTuner.GetSize());
+					std::cout << "SDK buffers resized to " << bufferTuner.GetSize() << " s" << std::endl;
+				}
+
+				// Feed clock model with arrival of newest sample
+				if (sampleCount != 0)
+				{
+					watchdog.Beat(WATCHDOG_EEG_SAMPLES, fetchTime);
+					eegSampleIndex += sampleCount;
+					clockEstimator.Add(eegSampleIndex - 1.0, fetchTime);
+				}
+
+				// ###############################
+				// ### MOTION STREAM EXECUTION ###
+				// ###############################
+
+				// Fetch motion samples in the same iteration as EEG
+				unsigned int motionSampleCount = 0;
+				if (upOutletMotion && (gateMotion.Update(*upOutletMotion, fetchTime) || mSampleCallbacks[ACQUISITION_STREAM_MOTION]))
+				{
+					motionSampleCount = rEngine.GetSampleCount(motionStream);
+				}
+
+				// Proceed when there are samples
+				if (motionSampleCount != 0)
+				{
+					// Prepare local buffer for data
+					motionChannelData.resize((size_t)motionChannelCount * motionSampleCount);
+					for (int i = 0; i < (int)motionChannelCount; i++)
+					{
+						motionChannelPointers[i] = &motionChannelData[(size_t)i * motionSampleCount];
+					}
+
+					// Fetch data
+					rEngine.GetMotion(motionStream, motionChannelList, motionChannelCount, motionChannelPointers.data(), motionSampleCount);
+
+					// Interleave samples, stamped like the EEG samples
+					motionBlock.Resize(motionChannelCount, motionSampleCount);
+					for (int sampleIdx = 0; sampleIdx < (int)motionSampleCount; sampleIdx++) // go over samples
+					{
+						for (int channelIdx = 0; channelIdx < (int)motionChannelCount; channelIdx++) // go over channels
+						{
+							motionBlock.values[(size_t)sampleIdx * motionChannelCount + channelIdx] = (float)motionChannelPointers[channelIdx][sampleIdx];
+						}
+					}
+					motionBlock.StampBackwards(fetchTime, sampleRateMotion);
+
+					// Output samples to LabStreamingLayer and host
+					upOutletMotion->push_chunk_multiplexed(motionBlock.values, motionBlock.timestamps);
+					if (mSampleCallbacks[ACQUISITION_STREAM_MOTION])
+					{
+						mSampleCallbacks[ACQUISITION_STREAM_MOTION](motionBlock);
+					}
+				}
+
+				// ############################################
+				// ### EMO STATE DEPENDENT STREAM EXECUTION ###
+				// ############################################
+
+				// Intermediate states are stamped relative to the newest one by their time since engine start
+				double now = lsl::local_clock();
+				for (unsigned int stateIdx = 0; stateIdx < pendingStateCount; stateIdx++)
+				{
+					double timestamp = now - (pendingStates[pendingStateCount - 1].timeFromStart - pendingStates[stateIdx].timeFromStart);
+					if (facialExpressionOpen)
+					{
+						PushFacialExpression(*upOutletFacialExpression, pendingStates[stateIdx], timestamp);
+					}
+					if (performanceMetricsOpen)
+					{
+						PushPerformanceMetrics(*upOutletPerformanceMetrics, pendingStates[stateIdx], performanceMetricsStatistics, timestamp);
+					}
+				}
+			}
+
+			// ###############################
+			// ### HYPERSCANNING EXECUTION ###
+			// ###############################
+
+			// Each participant is acquired on its own data handle and aligned to the common grid
+			if (upHyperscanAggregator)
+			{
+				upHyperscanAggregator->Update(lsl::local_clock());
+			}
+
+			// ###################
+			// ### DIAGNOSTICS ###
+			// ###################
+
+			// Update clock model values and publish them when due
+			if (readyToCollect && spEEGChain && clockEstimator.IsValid())
+			{
+				double effectiveRate = clockEstimator.GetEffectiveRate();
+				diagnostics.Set(DIAGNOSTICS_EFFECTIVE_RATE, effectiveRate);
+				diagnostics.Set(DIAGNOSTICS_DRIFT, (effectiveRate / spEEGChain->GetDevice().sampleRate - 1.0) * 1e6);
+				diagnostics.Set(DIAGNOSTICS_CLOCK_OFFSET, clockEstimator.GetOffset());
+				diagnostics.Set(DIAGNOSTICS_JITTER, clockEstimator.GetJitter());
+			}
+			diagnostics.Set(DIAGNOSTICS_RING_OVERFLOWS, (double)eegRing.GetOverflows());
+			diagnostics.Set(DIAGNOSTICS_RING_UNDERRUNS, (double)eegRing.GetUnderruns());
+			diagnostics.Set(DIAGNOSTICS_RING_DROPPED_OLDEST, (double)eegRing.GetDroppedOldest());
+			diagnostics.Set(DIAGNOSTICS_RING_BLOCKS, (double)eegRing.GetBlocks());
+			diagnostics.Set(DIAGNOSTICS_RESIDENT_MEMORY, residentMemory / (1024.0 * 1024.0));
+			diagnostics.Set(DIAGNOSTICS_BUFFER_SIZE, bufferTuner.GetSize());
+			diagnostics.Set(DIAGNOSTICS_BUFFER_PEAK_FILL, bufferTuner.GetPeakFill());
+			diagnostics.Set(DIAGNOSTICS_BUFFER_NEAR_OVERFLOWS, (double)bufferTuner.GetNearOverflowCount());
+			diagnostics.Set(DIAGNOSTICS_WAKEUP_LATENESS_MEAN, loopTimer.GetMeanLateness());
+			diagnostics.Set(DIAGNOSTICS_WAKEUP_LATENESS_MAX, loopTimer.GetMaxLateness());
+			diagnostics.Set(DIAGNOSTICS_MISSED_DEADLINES, (double)loopTimer.GetMissedDeadlineCount());
+			ArtifactSubspaceReconstruction* pAsr = spEEGChain ? spEEGChain->GetAsr() : nullptr;
+			if (pAsr)
+			{
+				diagnostics.Set(DIAGNOSTICS_ASR_PROCESSING_MAX, pAsr->GetMaxProcessingTime());
+				diagnostics.Set(DIAGNOSTICS_ASR_BUDGET_OVERRUNS, (double)pAsr->GetBudgetOverrunCount());
+				diagnostics.Set(DIAGNOSTICS_ASR_REMOVED_COMPONENTS, pAsr->GetRemovedComponentCount());
+			}
+			if (spEEGChain)
+			{
+				// Latencies measured by pipeline workers are taken per interval, right before it is published
+				if (diagnostics.IsDue(tickTime))
+				{
+					LatencyInterval predictionLatency = spEEGChain->GetPredictionLatency().TakeInterval();
+					diagnostics.Set(DIAGNOSTICS_PREDICTION_LATENCY_MEAN, predictionLatency.mean);
+					diagnostics.Set(DIAGNOSTICS_PREDICTION_LATENCY_MAX, predictionLatency.max);
+					diagnostics.Set(DIAGNOSTICS_PIPELINE_LATENCY_MAX, spEEGChain->GetPipeline().GetLatency().TakeInterval().max);
+				}
+				diagnostics.Set(DIAGNOSTICS_PIPELINE_DROPPED_BLOCKS, (double)spEEGChain->GetPipeline().GetDroppedBlockCount());
+			}
+			if (diagnostics.Update(tickTime))
+			{
+				if (pAsr)
+				{
+					pAsr->ResetMaxProcessingTime();
+				}
+				if (spEEGChain)
+				{
+					spEEGChain->PublishPipelineTiming();
+				}
+				bufferTuner.ResetPeakFill();
+
+				// Lateness is told per interval, overall values are kept for the summary
+				maxWakeupLateness = std::max(maxWakeupLateness, loopTimer.GetMaxLateness());
+				missedDeadlines += loopTimer.GetMissedDeadlineCount();
+				loopTimer.ResetStatistics();
+
+				// Measured now, sent with next sample
+				residentMemory = GetResidentMemory();
+				peakResidentMemory = std::max(peakResidentMemory, residentMemory);
+			}
+
+			// ##################
+			// ### STATISTICS ###
+			// ##################
+
+			// Exception of sample callback ends acquisition like one of its own
+			if (upEEGSubscriber && upEEGSubscriber->HasFailed())
+			{
+				throw std::runtime_error("Sample callback failed: " + upEEGSubscriber->GetError());
+			}
+
+			// Snapshot for host
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mStatistics.engineConnected = supervisor.IsConnected();
+				mStatistics.userPresent = readyToCollect;
+				mStatistics.effectiveSampleRate = diagnostics.Get(DIAGNOSTICS_EFFECTIVE_RATE);
+				mStatistics.drift = diagnostics.Get(DIAGNOSTICS_DRIFT);
+				mStatistics.jitter = diagnostics.Get(DIAGNOSTICS_JITTER);
+				mStatistics.publishedBlockCount = eegPublisher.GetPublishedBlockCount();
+				mStatistics.droppedBlockCount = eegRing.GetOverflows() + eegRing.GetDroppedOldest();
+				mStatistics.lostBlockCount = upEEGSubscriber ? upEEGSubscriber->GetLostCount() : 0;
+				mStatistics.stallCount = watchdog.GetStallCount();
+				mStatistics.residentMemory = residentMemory / (1024.0 * 1024.0);
+			}
+
+			// #############
+			// ### SLEEP ###
+			// #############
+
+			// Replay ends with its trace
+			if (rEngine.IsFinished())
+			{
+				std::cout << "Replay finished after " << (int)((lsl::local_clock() - startTime) * 1000.0) << " ms" << std::endl;
+				break;
+			}
+
+			// Sleep until next iteration is due to collect further data, unless replaying as fast as possible
+			if (rEngine.IsPaced())
+			{
+				loopTimer.Wait();
+			}
+		}
+
+		// Publish what is left in the ring
+		watchdog.Disarm(WATCHDOG_ACQUISITION, lsl::local_clock());
+		watchdog.Disarm(WATCHDOG_EEG_SAMPLES, lsl::local_clock());
+		eegPublisher.Stop();
+
+		// Summary of clock model as last diagnostics sample
+		diagnostics.Set(DIAGNOSTICS_FINAL, 1.0);
+		diagnostics.Publish(lsl::local_clock());
+		std::cout << "Effective EEG sample rate: " << diagnostics.Get(DIAGNOSTICS_EFFECTIVE_RATE) << " Hz ("
+			<< diagnostics.Get(DIAGNOSTICS_DRIFT) << " ppm drift), jitter: " << diagnostics.Get(DIAGNOSTICS_JITTER) * 1000.0 << " ms" << std::endl;
+
+		// Tell user about handover between acquisition and publishing
+		std::cout << "EEG blocks published: " << eegPublisher.GetPublishedBlockCount() << ", dropped: " << eegRing.GetOverflows()
+			<< ", dropped as oldest: " << eegRing.GetDroppedOldest() << ", acquisition blocked: " << eegRing.GetBlocks() << " times" << std::endl;
+		std::cout << "Peak resident memory: " << peakResidentMemory / (1024 * 1024) << " MiB" << std::endl;
+		std::cout << "SDK buffer size: " << bufferTuner.GetSize() << " s, updates near overflow: " << bufferTuner.GetNearOverflowCount() << std::endl;
+		if (spEEGChain && spEEGChain->GetPipeline().GetStageCount() > 0)
+		{
+			std::cout << "EEG blocks dropped by pipeline stages: " << spEEGChain->GetPipeline().GetDroppedBlockCount() << std::endl;
+		}
+
+		// Tell user about timing of main loop
+		maxWakeupLateness = std::max(maxWakeupLateness, loopTimer.GetMaxLateness());
+		missedDeadlines += loopTimer.GetMissedDeadlineCount();
+		std::cout << "Maximal wakeup lateness: " << maxWakeupLateness * 1000.0 << " ms, missed iterations: " << missedDeadlines << std::endl;
+
+		// Tell user about stalls
+		if (watchdog.IsEnabled())
+		{
+			std::cout << "Stalls alarmed: " << watchdog.GetStallCount() << std::endl;
+		}
+
+		// Tell user about hyperscanning
+		if (upHyperscanAggregator)
+		{
+			std::cout << "Hyperscanning samples dropped: " << upHyperscanAggregator->GetDroppedSampleCount()
+				<< ", missing: " << upHyperscanAggregator->GetMissingSampleCount() << std::endl;
+		}
+
+		// Tell user about event handling
+		std::cout << "Events drained: " << eventsDrained << ", EmoStates coalesced: " << emoStatesCoalesced << std::endl;
+	}
+	catch (const std::exception& e) // some exception occured, no exception may leave the thread
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mError = e.what();
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mError = "Unknown exception in acquisition thread";
+	}
+
+	// Disconnect from Emotiv device
+	if (upEngine)
+	{
+		upEngine->Disconnect();
+	}
+
+	// Tell that thread has ended, also when it ended on its own. Another acquisition may start from now on
+	acquisitionRunning = false;
+	mRunning = false;
+}
+
+lsl::stream_info CreateMotionStreamInfo(double sampleRate)
+{
+	// Start filling information about stream
+	lsl::stream_info streamInfoMotion("EmotivLSL_Motion", "Mocap", motionChannelCount, sampleRate, lsl::cf_float32, "source_id");
+	streamInfoMotion.desc().append_child_value("manufacturer", "Emotiv");
+
+	// Save information about channels
+	lsl::xml_element motionChannels = streamInfoMotion.desc().append_child("channels");
+	for (const auto& rMotionChannelLabel : motionChannelLabels)
+	{
+		motionChannels.append_child("channel")
+			.append_child_value("label", rMotionChannelLabel.first)
+			.append_child_value("type", rMotionChannelLabel.second);
+	}
+	return streamInfoMotion;
+}
+
+lsl::stream_info CreateFacialExpressionStreamInfo()
+{
+	// Start filling information about stream
+	lsl::stream_info streamInfoFacialExpression("EmotivLSL_FacialExpression", "VALUE", facialExpressionLabels.size(), lsl::IRREGULAR_RATE, lsl::cf_float32, "source_id");
+	streamInfoFacialExpression.desc().append_child_value("manufacturer", "Emotiv");
+
+	// Save information about facial expressions
+	lsl::xml_element facialExpressions = streamInfoFacialExpression.desc().append_child("channels");
+	for (auto facialExpressionLabel : facialExpressionLabels)
+	{
+		facialExpressions.append_child("channel")
+			.append_child_value("label", facialExpressionLabel);
+	}
+	return streamInfoFacialExpression;
+}
+
+lsl::stream_info CreatePerformanceMetricsStreamInfo()
+{
+	// Start filling information about stream
+	lsl::stream_info streamInfoPerformanceMetrics("EmotivLSL_PerformanceMetrics", "VALUE", performanceMetricsLabels.size(), lsl::IRREGULAR_RATE, lsl::cf_float32, "source_id");
+	streamInfoPerformanceMetrics.desc().append_child_value("manufacturer", "Emotiv");
+
+	// Save information about performance metrics
+	lsl::xml_element performanceMetrics = streamInfoPerformanceMetrics.desc().append_child("channels");
+	for (auto performanceMetricsLabel : performanceMetricsLabels)
+	{
+		performanceMetrics.append_child("channel")
+			.append_child_value("label", performanceMetricsLabel);
+	}
+	return streamInfoPerformanceMetrics;
+}
+
+std::unique_ptr<EngineBackend> CreateEngineBackend(const Config& rConfig)
+{
+	// EmoEngine is replaced by a trace on request, e.g. for benchmarks without headset
+	std::unique_ptr<EngineBackend> upEngine;
+	std::string replayFilepath = rConfig.GetString("engineReplay", "");
+	if (replayFilepath.empty())
+	{
+#ifdef EMOTIVLSL_REPLAY_ONLY
+		throw std::runtime_error("Built without EmoEngine, a trace to replay must be configured");
+#else
+		upEngine = std::unique_ptr<EngineBackend>(new LiveEngine());
+#endif
+	}
+	else
+	{
+		std::string timing = rConfig.GetString("engineReplayTiming", "original");
+		if (timing != "original" && timing != "fast")
+		{
+			throw std::runtime_error("Unknown replay timing: " + timing);
+		}
+		upEngine = std::unique_ptr<EngineBackend>(new TraceReplayer(replayFilepath, timing == "original"));
+		std::cout << "Replaying EmoEngine from " << replayFilepath << std::endl;
+	}
+
+	// Calls are recorded around the backend
+	std::string traceFilepath = rConfig.GetString("engineTrace", "");
+	if (!traceFilepath.empty())
+	{
+		upEngine = std::unique_ptr<EngineBackend>(new TraceRecorder(std::move(upEngine), traceFilepath));
+		std::cout << "Recording EmoEngine calls to " << traceFilepath << std::endl;
+	}
+	return upEngine;
+}
+
+std::future<std::unique_ptr<lsl::stream_outlet> > CreateOutletAsync(const lsl::stream_info& rInfo, const Config& rConfig)
+{
+	// Configuration outlives the future, which is waited for by acquisition
+	return std::async(std::launch::async, [rInfo, &rConfig]() { return CreateOutlet(rInfo, rConfig); });
+}
+
+void PushFacialExpression(lsl::stream_outlet& rOutlet, const EmoStateSnapshot& rState, double timestamp)
+{
+	// TODO: what about the training stuff in the example code?
+	std::vector<float> values;
+
+	// Get face status
+	IEE_FacialExpressionAlgo_t upperFaceType = rState.upperFaceAction;
+	IEE_FacialExpressionAlgo_t lowerFaceType = rState.lowerFaceAction;
+	float upperFaceAmp = rState.upperFacePower;
+	float lowerFaceAmp = rState.lowerFacePower;
+
+	// Blink
+	values.push_back(rState.blink ? 1.f : 0.f);
+
+	// Wink left
+	values.push_back(rState.winkLeft ? 1.f : 0.f);
+
+	// Wink right
+	values.push_back(rState.winkRight ? 1.f : 0.f);
+
+	// Suprise
+	values.push_back((upperFaceAmp > 0.f && upperFaceType == FE_SURPRISE) ? 1.f : 0.f);
+
+	// Frown
+	values.push_back((upperFaceAmp > 0.f && upperFaceType == FE_FROWN) ? 1.f : 0.f);
+
+	// Clench
+	values.push_back((lowerFaceAmp > 0.f && lowerFaceType == FE_CLENCH) ? 1.f : 0.f);
+
+	// Smile
+	values.push_back((lowerFaceAmp > 0.f && lowerFaceType == FE_SMILE) ? 1.f : 0.f);
+
+	// Neutral
+	bool neutral = true; // if nothing else is set, set neutral to one
+	for (const float& rValue : values) { if (rValue > 0.f) { neutral = false; break; } }
+	if(neutral)
+	{
+		values.push_back(1.f);
+	}
+	else
+	{
+		values.push_back(0.f);
+	}
+
+	// Push back sample
+	rOutlet.push_sample(values, timestamp);
+
+	// Tell user on console
+	std::cout << "Facial Expression Sample collected" << std::endl;
+}
+
+void PushPerformanceMetrics(lsl::stream_outlet& rOutlet, const EmoStateSnapshot& rState, std::vector<RollingStatistics>& rStatistics, double timestamp)
+{
+	std::vector<float> values;
+	double scaledScore = 0;
+
+	// Stress, boredom, relaxation, excitement and interest
+	for (int metricIdx = 0; metricIdx < PERFORMANCE_METRIC_COUNT; metricIdx++)
+	{
+		double rawScore = rState.performanceMetrics[metricIdx][0];
+		double minScale = rState.performanceMetrics[metricIdx][1];
+		double maxScale = rState.performanceMetrics[metricIdx][2];
+		values.push_back((float)rawScore);
+		values.push_back((float)minScale);
+		values.push_back((float)maxScale);
+		if (minScale == maxScale)
+		{
+			values.push_back(std::numeric_limits<float>::quiet_NaN());
+		}
+		else
+		{
+			CaculateScale(rawScore, maxScale, minScale, scaledScore);
+			values.push_back((float)scaledScore);
+		}
+	}
+
+	// Normalized over window including the current score, so there is output from the first EmoState on
+	for (int metricIdx = 0; metricIdx < PERFORMANCE_METRIC_COUNT; metricIdx++)
+	{
+		double rawScore = rState.performanceMetrics[metricIdx][0];
+		rStatistics[metricIdx].Add(rawScore, timestamp);
+		values.push_back((float)rStatistics[metricIdx].GetZScore(rawScore));
+		values.push_back((float)rStatistics[metricIdx].GetWindowScaled(rawScore));
+	}
+
+	// Push back sample
+	rOutlet.push_sample(values, timestamp);
+
+	// Tell user on console
+	std::cout << "Performance Metrics Sample collected" << std::endl;
+}
+
+void CaculateScale(double& rawScore, double& maxScale, double& minScale, double& scaledScore)
+{
+	if (rawScore < minScale)
+	{
+		scaledScore = 0;
+	}
+	else if (rawScore > maxScale)
+	{
+		scaledScore = 1;
+	}
+	else
+	{
+		scaledScore = (rawScore - minScale) / (maxScale - minScale);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Acquisition from the EmoEngine and publishing to LabStreamingLayer, running
+// on a thread of its own between Start and Stop. Hosts embedding EmotivLSL can
+// register callbacks to receive samples in-process, without the detour over
+// the network transport of LabStreamingLayer. The EmoEngine is a resource of
+// the process, so only one acquisition may run at a time.
+
+#ifndef ACQUISITION_H_
+#define ACQUISITION_H_
+
+#include "Config.h"
+#include "SampleBlock.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Streams whose samples can be received in-process
+enum AcquisitionStream
+{
+	ACQUISITION_STREAM_EEG, // samples as acquired, before re-referencing, called by a subscriber thread
+	ACQUISITION_STREAM_MOTION, // samples as published on EmotivLSL_Motion, called by acquisition thread
+	ACQUISITION_STREAM_COUNT
+};
+
+// Snapshot of statistics, updated once per iteration
+struct AcquisitionStatistics
+{
+	bool engineConnected = false;
+	bool userPresent = false;
+	double effectiveSampleRate = 0.0; // Hz
+	double drift = 0.0; // parts per million
+	double jitter = 0.0; // seconds
+	unsigned long long publishedBlockCount = 0;
+	unsigned long long droppedBlockCount = 0;
+	unsigned long long lostBlockCount = 0; // blocks the EEG callback was too slow for
+	unsigned long long stallCount = 0;
+	double residentMemory = 0.0; // MiB
+};
+
+class Acquisition
+{
+public:
+
+	// Callback receiving a block of samples, which is only valid during the call
+	typedef std::function<void(const SampleBlock&)> SampleCallback;
+
+	// Constructor with configuration, which is copied
+	Acquisition(const Config& rConfig);
+
+	// Destructor, stops acquisition
+	~Acquisition();
+
+	// Set callback for samples of stream. Must be called before start
+	void SetSampleCallback(AcquisitionStream stream, SampleCallback callback);
+
+	// Start acquisition thread. Returns false when this or another acquisition of the process is running
+	bool Start();
+
+	// Stop acquisition thread, which publishes a summary before ending
+	void Stop();
+
+	// Whether acquisition thread is running. It ends on its own after an error or at the end of a replayed trace
+	bool IsRunning() const { return mRunning.load(); }
+
+	// Getters, safe to call from any thread
+	AcquisitionStatistics GetStatistics() const;
+	std::string GetError() const;
+
+private:
+
+	// Loop of thread, formerly the main function of EmotivLSL
+	void Run();
+
+	// Members
+	Config mConfig;
+	SampleCallback mSampleCallbacks[ACQUISITION_STREAM_COUNT];
+	double mStartTime = 0.0;
+	AcquisitionStatistics mStatistics; // guarded by mutex
+	std::string mError; // guarded by mutex
+	mutable std::mutex mMutex;
+	std::atomic<bool> mRunning{ false };
+	std::thread mThread;
+};
+
+#endif // ACQUISITION_H_
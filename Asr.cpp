@@ -0,0 +1,370 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "Asr.h"
+#include "SymmetricEigen.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Defines
+const unsigned int asrSweepCount = 8; // sweeps of eigendecomposition, enough for 14 channels in double precision
+const double asrMaxRemovedFraction = 0.66; // share of components which may be removed at most
+const double asrOffsetTimeConstant = 5.0; // seconds over which channel offsets are tracked
+
+// Multiply square matrices of size n stored row by row, result = a * b
+static void Multiply(const std::vector<double>& rA, const std::vector<double>& rB, unsigned int n, std::vector<double>& rResult)
+{
+	rResult.assign((size_t)n * n, 0.0);
+	for (unsigned int i = 0; i < n; i++)
+	{
+		for (unsigned int k = 0; k < n; k++)
+		{
+			double aik = rA[(size_t)i * n + k];
+			for (unsigned int j = 0; j < n; j++)
+			{
+				rResult[(size_t)i * n + j] += aik * rB[(size_t)k * n + j];
+			}
+		}
+	}
+}
+
+// Transpose square matrix of size n stored row by row
+static std::vector<double> Transpose(const std::vector<double>& rA, unsigned int n)
+{
+	std::vector<double> result((size_t)n * n);
+	for (unsigned int i = 0; i < n; i++)
+	{
+		for (unsigned int j = 0; j < n; j++)
+		{
+			result[(size_t)j * n + i] = rA[(size_t)i * n + j];
+		}
+	}
+	return result;
+}
+
+// Compose eigenvectors with function of eigenvalues, result = v * diag(f(e)) * v^T
+template<typename Function>
+static void Compose(const std::vector<double>& rEigenvalues, const std::vector<double>& rEigenvectors, unsigned int n, Function function, std::vector<double>& rResult)
+{
+	rResult.assign((size_t)n * n, 0.0);
+	for (unsigned int k = 0; k < n; k++)
+	{
+		double factor = function(rEigenvalues[k]);
+		for (unsigned int i = 0; i < n; i++)
+		{
+			double vik = rEigenvectors[(size_t)i * n + k] * factor;
+			for (unsigned int j = 0; j < n; j++)
+			{
+				rResult[(size_t)i * n + j] += vik * rEigenvectors[(size_t)j * n + k];
+			}
+		}
+	}
+}
+
+ArtifactSubspaceReconstruction::ArtifactSubspaceReconstruction(unsigned int channelCount, double sampleRate, double calibrationDuration,
+	double cutoff, double windowDuration, double latencyBudget) :
+	mChannelCount(channelCount),
+	mSampleRate(sampleRate),
+	mCalibrationSampleCount((unsigned int)(calibrationDuration * sampleRate)),
+	mCutoff(cutoff),
+	mCovarianceDecay(std::exp(-1.0 / (windowDuration * sampleRate))),
+	mOffsetDecay(std::exp(-1.0 / (asrOffsetTimeConstant * sampleRate))),
+	mLatencyBudget(latencyBudget)
+{
+	Reset();
+}
+
+bool ArtifactSubspaceReconstruction::Process(const SampleBlock& rInput, SampleBlock& rOutput)
+{
+	unsigned int sampleCount = rInput.SampleCount();
+	unsigned int n = mChannelCount;
+
+	// Collect calibration data first
+	if (!mCalibrated)
+	{
+		rOutput.Resize(n, 0);
+		mCalibrationData.insert(mCalibrationData.end(), rInput.values.begin(), rInput.values.end());
+		if (mCalibrationData.size() >= (size_t)mCalibrationSampleCount * n)
+		{
+			Calibrate();
+		}
+		return false;
+	}
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	rOutput.Resize(n, sampleCount);
+	rOutput.timestamps = rInput.timestamps;
+
+	// Track offsets and covariance sample by sample, upper triangle only
+	mCentered.resize((size_t)sampleCount * n);
+	double covarianceWeight = 1.0 - mCovarianceDecay;
+	for (unsigned int sampleIdx = 0; sampleIdx < sampleCount; sampleIdx++)
+	{
+		const float* pInput = &rInput.values[(size_t)sampleIdx * n];
+		double* pCentered = &mCentered[(size_t)sampleIdx * n];
+		for (unsigned int i = 0; i < n; i++)
+		{
+			mOffsets[i] = mOffsetDecay * mOffsets[i] + (1.0 - mOffsetDecay) * pInput[i];
+			pCentered[i] = pInput[i] - mOffsets[i];
+		}
+		for (unsigned int i = 0; i < n; i++)
+		{
+			double weighted = covarianceWeight * pCentered[i];
+			double* pRow = &mCovariance[(size_t)i * n];
+			for (unsigned int j = i; j < n; j++)
+			{
+				pRow[j] = mCovarianceDecay * pRow[j] + weighted * pCentered[j];
+			}
+		}
+	}
+	for (unsigned int i = 0; i < n; i++)
+	{
+		for (unsigned int j = 0; j < i; j++)
+		{
+			mCovariance[(size_t)i * n + j] = mCovariance[(size_t)j * n + i];
+		}
+	}
+
+	// Decompose unless the previous block ran out of time
+	if (!mSkipDecomposition)
+	{
+		UpdateReconstruction();
+	}
+
+	// Apply reconstruction, blending from the one of the previous block to avoid steps
+	for (unsigned int sampleIdx = 0; sampleIdx < sampleCount; sampleIdx++)
+	{
+		const float* pInput = &rInput.values[(size_t)sampleIdx * n];
+		const double* pCentered = &mCentered[(size_t)sampleIdx * n];
+		float* pOutput = &rOutput.values[(size_t)sampleIdx * n];
+		double blend = (double)(sampleIdx + 1) / sampleCount;
+		for (unsigned int i = 0; i < n; i++)
+		{
+			const float* pCurrentRow = &mReconstruction[(size_t)i * n];
+			const float* pPreviousRow = &mPreviousReconstruction[(size_t)i * n];
+			double current = 0.0;
+			double previous = 0.0;
+			for (unsigned int j = 0; j < n; j++)
+			{
+				current += pCurrentRow[j] * pCentered[j];
+				previous += pPreviousRow[j] * pCentered[j];
+			}
+			pOutput[i] = (float)(previous + blend * (current - previous) + (pInput[i] - pCentered[i]));
+		}
+	}
+	mPreviousReconstruction = mReconstruction;
+
+	// Keep track of latency, next block takes the cheap path after an overrun
+	double processingTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (processingTime > mMaxProcessingTime.load())
+	{
+		mMaxProcessingTime = processingTime;
+	}
+	mSkipDecomposition = processingTime > mLatencyBudget;
+	if (mSkipDecomposition)
+	{
+		mBudgetOverrunCount++;
+	}
+	return true;
+}
+
+void ArtifactSubspaceReconstruction::Reset()
+{
+	unsigned int n = mChannelCount;
+	mCalibrated = false;
+	mSkipDecomposition = false;
+	mCalibrationData.clear();
+	mCalibrationData.reserve((size_t)mCalibrationSampleCount * n);
+	mOffsets.assign(n, 0.0);
+	mCovariance.assign((size_t)n * n, 0.0);
+	mReconstruction.assign((size_t)n * n, 0.f);
+	for (unsigned int i = 0; i < n; i++)
+	{
+		mReconstruction[(size_t)i * n + i] = 1.f;
+	}
+	mPreviousReconstruction = mReconstruction;
+	mRemovedComponentCount = 0;
+}
+
+void ArtifactSubspaceReconstruction::Calibrate()
+{
+	unsigned int n = mChannelCount;
+	unsigned int sampleCount = (unsigned int)(mCalibrationData.size() / n);
+
+	// Offsets are the means of the calibration data
+	for (unsigned int sampleIdx = 0; sampleIdx < sampleCount; sampleIdx++)
+	{
+		for (unsigned int i = 0; i < n; i++)
+		{
+			mOffsets[i] += mCalibrationData[(size_t)sampleIdx * n + i];
+		}
+	}
+	for (double& rOffset : mOffsets)
+	{
+		rOffset /= sampleCount;
+	}
+
+	// Covariance of calibration data
+	std::vector<double> centered(n);
+	for (unsigned int sampleIdx = 0; sampleIdx < sampleCount; sampleIdx++)
+	{
+		for (unsigned int i = 0; i < n; i++)
+		{
+			centered[i] = mCalibrationData[(size_t)sampleIdx * n + i] - mOffsets[i];
+		}
+		for (unsigned int i = 0; i < n; i++)
+		{
+			for (unsigned int j = 0; j < n; j++)
+			{
+				mCovariance[(size_t)i * n + j] += centered[i] * centered[j] / sampleCount;
+			}
+		}
+	}
+
+	// Mixing matrix is the square root of the covariance, sharing its eigenvectors
+	std::vector<double> eigenvalues;
+	std::vector<double> eigenvectors;
+	SymmetricEigen(mCovariance, n, asrSweepCount, eigenvalues, eigenvectors);
+	Compose(eigenvalues, eigenvectors, n, [](double e) { return std::sqrt(std::max(e, 0.0)); }, mMixing);
+
+	// Amplitude statistics of components over windows of the covariance window length
+	unsigned int windowLength = std::max(1u, (unsigned int)(-1.0 / std::log(mCovarianceDecay)));
+	unsigned int windowCount = std::max(1u, sampleCount / windowLength);
+	std::vector<double> rmsSum(n, 0.0);
+	std::vector<double> rmsSquareSum(n, 0.0);
+	for (unsigned int windowIdx = 0; windowIdx < windowCount; windowIdx++)
+	{
+		std::vector<double> powers(n, 0.0);
+		unsigned int windowEnd = std::min(sampleCount, (windowIdx + 1) * windowLength);
+		for (unsigned int sampleIdx = windowIdx * windowLength; sampleIdx < windowEnd; sampleIdx++)
+		{
+			for (unsigned int k = 0; k < n; k++)
+			{
+				double component = 0.0;
+				for (unsigned int i = 0; i < n; i++)
+				{
+					component += (mCalibrationData[(size_t)sampleIdx * n + i] - mOffsets[i]) * eigenvectors[(size_t)i * n + k];
+				}
+				powers[k] += component * component;
+			}
+		}
+		for (unsigned int k = 0; k < n; k++)
+		{
+			double rms = std::sqrt(powers[k] / (windowEnd - windowIdx * windowLength));
+			rmsSum[k] += rms;
+			rmsSquareSum[k] += rms * rms;
+		}
+	}
+
+	// Thresholds are mean plus cutoff times standard deviation of component amplitudes
+	mThresholds.assign((size_t)n * n, 0.0);
+	for (unsigned int k = 0; k < n; k++)
+	{
+		double mean = rmsSum[k] / windowCount;
+		double deviation = std::sqrt(std::max(rmsSquareSum[k] / windowCount - mean * mean, 0.0));
+		double threshold = mean + mCutoff * deviation;
+		for (unsigned int i = 0; i < n; i++)
+		{
+			mThresholds[(size_t)k * n + i] = threshold * eigenvectors[(size_t)i * n + k];
+		}
+	}
+
+	// Calibration data is not needed anymore
+	mCalibrated = true;
+	std::vector<float>().swap(mCalibrationData);
+}
+
+void ArtifactSubspaceReconstruction::UpdateReconstruction()
+{
+	unsigned int n = mChannelCount;
+
+	// Components of current covariance
+	std::vector<double> eigenvalues;
+	std::vector<double> eigenvectors;
+	SymmetricEigen(mCovariance, n, asrSweepCount, eigenvalues, eigenvectors);
+
+	// Components keep their variance while it is below the threshold in their direction. The
+	// weakest ones are kept in any case
+	std::vector<double> thresholdsOfComponents;
+	Multiply(mThresholds, eigenvectors, n, thresholdsOfComponents);
+	unsigned int alwaysKeptCount = n - (unsigned int)(asrMaxRemovedFraction * n);
+	std::vector<bool> keep(n);
+	unsigned int removedCount = 0;
+	for (unsigned int k = 0; k < n; k++)
+	{
+		double limit = 0.0;
+		for (unsigned int i = 0; i < n; i++)
+		{
+			limit += thresholdsOfComponents[(size_t)i * n + k] * thresholdsOfComponents[(size_t)i * n + k];
+		}
+		keep[k] = k < alwaysKeptCount || eigenvalues[k] < limit;
+		removedCount += keep[k] ? 0 : 1;
+	}
+	mRemovedComponentCount = removedCount;
+
+	// Nothing to reconstruct
+	if (removedCount == 0)
+	{
+		std::fill(mReconstruction.begin(), mReconstruction.end(), 0.f);
+		for (unsigned int i = 0; i < n; i++)
+		{
+			mReconstruction[(size_t)i * n + i] = 1.f;
+		}
+		return;
+	}
+
+	// Kept components of mixing matrix, a = diag(keep) * v^T * m
+	std::vector<double> transposedEigenvectors = Transpose(eigenvectors, n);
+	std::vector<double> a;
+	Multiply(transposedEigenvectors, mMixing, n, a);
+	for (unsigned int k = 0; k < n; k++)
+	{
+		if (!keep[k])
+		{
+			std::fill(a.begin() + (size_t)k * n, a.begin() + (size_t)(k + 1) * n, 0.0);
+		}
+	}
+
+	// Pseudo inverse of a through the eigendecomposition of a^T * a
+	std::vector<double> transposedA = Transpose(a, n);
+	std::vector<double> gram;
+	Multiply(transposedA, a, n, gram);
+	std::vector<double> gramEigenvalues;
+	std::vector<double> gramEigenvectors;
+	SymmetricEigen(gram, n, asrSweepCount, gramEigenvalues, gramEigenvectors);
+	double tolerance = gramEigenvalues.back() * 1e-10;
+	std::vector<double> gramInverse;
+	Compose(gramEigenvalues, gramEigenvectors, n, [tolerance](double e) { return e > tolerance ? 1.0 / e : 0.0; }, gramInverse);
+	std::vector<double> pseudoInverse;
+	Multiply(gramInverse, transposedA, n, pseudoInverse);
+
+	// Reconstruction r = m * pinv(a) * v^T
+	std::vector<double> product;
+	Multiply(mMixing, pseudoInverse, n, product);
+	std::vector<double> reconstruction;
+	Multiply(product, transposedEigenvectors, n, reconstruction);
+	for (size_t i = 0; i < reconstruction.size(); i++)
+	{
+		mReconstruction[i] = (float)reconstruction[i];
+	}
+}
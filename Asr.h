@@ -0,0 +1,104 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Online artifact subspace reconstruction (ASR). A mixing matrix and per
+// component thresholds are calibrated from an initial window of data that is
+// assumed to be clean. Afterwards the covariance of the signal is tracked over
+// a short window, decomposed per block, and components whose variance exceeds
+// their threshold are reconstructed from the remaining ones. The offset of
+// every channel is tracked separately and restored after cleaning.
+//
+// Work per block is bounded: the covariance update is linear in the samples
+// and the eigendecomposition uses a fixed count of sweeps. When a block still
+// exceeds the latency budget, the next block reuses the previous
+// reconstruction instead of decomposing again.
+
+#ifndef ASR_H_
+#define ASR_H_
+
+#include "SampleBlock.h"
+
+#include <atomic>
+#include <vector>
+
+class ArtifactSubspaceReconstruction
+{
+public:
+
+	// Constructor with seconds of calibration data, cutoff in standard deviations of
+	// component amplitude, seconds of covariance window and latency budget per block in seconds
+	ArtifactSubspaceReconstruction(unsigned int channelCount, double sampleRate, double calibrationDuration,
+		double cutoff, double windowDuration, double latencyBudget);
+
+	// Clean input block into output block. Returns false while calibrating, then output is empty
+	bool Process(const SampleBlock& rInput, SampleBlock& rOutput);
+
+	// Start over with calibration
+	void Reset();
+
+	// Whether calibration is done
+	bool IsCalibrated() const { return mCalibrated; }
+
+	// Maximal processing time of a block in seconds since last reset
+	double GetMaxProcessingTime() const { return mMaxProcessingTime.load(); }
+
+	// Start over with maximal processing time, may be called from other thread
+	void ResetMaxProcessingTime() { mMaxProcessingTime = 0.0; }
+
+	// Count of blocks which exceeded the latency budget
+	unsigned long long GetBudgetOverrunCount() const { return mBudgetOverrunCount.load(); }
+
+	// Count of components removed from last block
+	unsigned int GetRemovedComponentCount() const { return mRemovedComponentCount.load(); }
+
+private:
+
+	// Derive mixing matrix and thresholds from calibration data
+	void Calibrate();
+
+	// Update reconstruction matrix from current covariance
+	void UpdateReconstruction();
+
+	// Members
+	unsigned int mChannelCount;
+	double mSampleRate;
+	unsigned int mCalibrationSampleCount;
+	double mCutoff;
+	double mCovarianceDecay; // per sample weight of old covariance
+	double mOffsetDecay; // per sample weight of old channel offsets
+	double mLatencyBudget;
+	bool mCalibrated = false;
+	bool mSkipDecomposition = false; // set when last block exceeded the budget
+	std::vector<float> mCalibrationData; // interleaved samples collected for calibration
+	std::vector<double> mOffsets; // tracked offset per channel
+	std::vector<double> mCovariance; // tracked covariance, row by row
+	std::vector<double> mMixing; // square root of calibration covariance
+	std::vector<double> mThresholds; // thresholds of calibration components, row by row as matrix applied to eigenvectors
+	std::vector<float> mReconstruction; // current reconstruction matrix, row by row
+	std::vector<float> mPreviousReconstruction; // reconstruction of previous block, blended into current one
+	std::vector<double> mCentered; // one sample minus offsets
+	std::atomic<double> mMaxProcessingTime{ 0.0 };
+	std::atomic<unsigned long long> mBudgetOverrunCount{ 0 };
+	std::atomic<unsigned int> mRemovedComponentCount{ 0 };
+};
+
+#endif // ASR_H_
@@ -0,0 +1,80 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "BufferTuner.h"
+
+#include <algorithm>
+
+// Defines
+const double nearOverflowFill = 0.9; // fill of an update that probably lost samples
+const double shrinkFill = 0.25; // buffer is halved when fill stays below, so it stays below one half afterwards
+const double shrinkPeriod = 30.0; // seconds fill has to stay low before buffer is halved
+
+BufferTuner::BufferTuner(double size, double minSize, double maxSize) :
+	mMinSize(minSize),
+	mMaxSize(std::max(minSize, maxSize))
+{
+	mSize = std::min(std::max(size, mMinSize), mMaxSize);
+}
+
+bool BufferTuner::Add(unsigned int sampleCount, double sampleRate, double now)
+{
+	double fill = sampleCount / (mSize * sampleRate);
+	mPeakFill = std::max(mPeakFill, fill);
+	if (mShrinkPeriodStart < 0.0)
+	{
+		RestartShrinkPeriod(now);
+	}
+	mShrinkPeriodPeakFill = std::max(mShrinkPeriodPeakFill, fill);
+
+	// Grow at once when samples were probably lost
+	if (fill >= nearOverflowFill)
+	{
+		mNearOverflowCount++;
+		RestartShrinkPeriod(now);
+		if (mSize < mMaxSize)
+		{
+			mSize = std::min(2.0 * mSize, mMaxSize);
+			return true;
+		}
+		return false;
+	}
+
+	// Shrink when fill stayed low over whole period
+	if (now - mShrinkPeriodStart >= shrinkPeriod)
+	{
+		bool shrink = mShrinkPeriodPeakFill < shrinkFill && mSize > mMinSize;
+		RestartShrinkPeriod(now);
+		if (shrink)
+		{
+			mSize = std::max(0.5 * mSize, mMinSize);
+			return true;
+		}
+	}
+	return false;
+}
+
+void BufferTuner::RestartShrinkPeriod(double now)
+{
+	mShrinkPeriodStart = now;
+	mShrinkPeriodPeakFill = 0.0;
+}
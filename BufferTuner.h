@@ -0,0 +1,68 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Size of the sample buffers of the EmoEngine, tuned to their fill. A buffer
+// holds samples for its size in seconds, samples arriving while it is full
+// are lost without notice. The fill of each update, the count of samples
+// relative to the capacity, is tracked. An update that fills the buffer
+// nearly completely is counted as probable data loss and the buffer is
+// doubled right away. When the fill stays low for a while, the buffer is
+// halved again, so memory is not wasted. Sizes stay within configured bounds.
+
+#ifndef BUFFER_TUNER_H_
+#define BUFFER_TUNER_H_
+
+class BufferTuner
+{
+public:
+
+	// Constructor with initial, minimal and maximal size in seconds
+	BufferTuner(double size, double minSize, double maxSize);
+
+	// Tell about count of samples taken from the buffer by an update. Returns whether size has changed
+	bool Add(unsigned int sampleCount, double sampleRate, double now);
+
+	// Start peak fill over, e.g. after it has been published
+	void ResetPeakFill() { mPeakFill = 0.0; }
+
+	// Getters
+	double GetSize() const { return mSize; }
+	double GetMaxSize() const { return mMaxSize; }
+	double GetPeakFill() const { return mPeakFill; } // highest fill since reset, one is a full buffer
+	unsigned long long GetNearOverflowCount() const { return mNearOverflowCount; }
+
+private:
+
+	// Start period over which low fill is observed
+	void RestartShrinkPeriod(double now);
+
+	// Members
+	double mSize;
+	double mMinSize;
+	double mMaxSize;
+	double mPeakFill = 0.0;
+	double mShrinkPeriodStart = -1.0; // negative before first update
+	double mShrinkPeriodPeakFill = 0.0;
+	unsigned long long mNearOverflowCount = 0;
+};
+
+#endif // BUFFER_TUNER_H_
@@ -0,0 +1,169 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "ClockEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Defines
+const unsigned int minimalFitCount = 8; // batches needed before estimates are given
+
+ClockEstimator::ClockEstimator(unsigned int windowSize) :
+	mIndices(std::max(windowSize, minimalFitCount)),
+	mTimes(std::max(windowSize, minimalFitCount))
+{
+	Reset();
+}
+
+void ClockEstimator::Add(double sampleIndex, double arrivalTime)
+{
+	// First batch defines the reference
+	if (mCount == 0)
+	{
+		mReferenceIndex = sampleIndex;
+		mReferenceTime = arrivalTime;
+	}
+
+	// Remove oldest batch from sums when window is full
+	unsigned int capacity = (unsigned int)mIndices.size();
+	if (mCount == capacity)
+	{
+		double x = mIndices[mNext] - mReferenceIndex;
+		double y = mTimes[mNext] - mReferenceTime;
+		mSumX -= x;
+		mSumY -= y;
+		mSumXX -= x * x;
+		mSumXY -= x * y;
+		mSumYY -= y * y;
+		mCount--;
+	}
+
+	// Add new batch
+	mIndices[mNext] = sampleIndex;
+	mTimes[mNext] = arrivalTime;
+	double x = sampleIndex - mReferenceIndex;
+	double y = arrivalTime - mReferenceTime;
+	mSumX += x;
+	mSumY += y;
+	mSumXX += x * x;
+	mSumXY += x * y;
+	mSumYY += y * y;
+	mCount++;
+	mNext = (mNext + 1) % capacity;
+
+	// Once per window length the reference moves along, so sums neither grow nor lose precision
+	if (++mAddedSinceRebase >= capacity)
+	{
+		Rebase();
+	}
+}
+
+void ClockEstimator::Reset()
+{
+	mNext = 0;
+	mCount = 0;
+	mAddedSinceRebase = 0;
+	mSumX = mSumY = mSumXX = mSumXY = mSumYY = 0.0;
+}
+
+bool ClockEstimator::IsValid() const
+{
+	if (mCount < minimalFitCount)
+	{
+		return false;
+	}
+	double n = mCount;
+	return (mSumXX - mSumX * mSumX / n) > 0.0;
+}
+
+double ClockEstimator::GetEffectiveRate() const
+{
+	double slope = 0.0;
+	double intercept = 0.0;
+	Fit(slope, intercept);
+	return slope > 0.0 ? 1.0 / slope : 0.0;
+}
+
+double ClockEstimator::GetOffset() const
+{
+	double slope = 0.0;
+	double intercept = 0.0;
+	Fit(slope, intercept);
+	return mReferenceTime + intercept - slope * mReferenceIndex;
+}
+
+double ClockEstimator::GetJitter() const
+{
+	if (mCount <= 2)
+	{
+		return 0.0;
+	}
+	double slope = 0.0;
+	double intercept = 0.0;
+	Fit(slope, intercept);
+
+	// Sum of squared residuals from the sums
+	double n = mCount;
+	double residual = mSumYY - 2.0 * intercept * mSumY - 2.0 * slope * mSumXY
+		+ n * intercept * intercept + 2.0 * slope * intercept * mSumX + slope * slope * mSumXX;
+	return std::sqrt(std::max(0.0, residual) / (n - 2.0));
+}
+
+void ClockEstimator::Fit(double& rSlope, double& rIntercept) const
+{
+	rSlope = 0.0;
+	rIntercept = 0.0;
+	if (!IsValid())
+	{
+		return;
+	}
+	double n = mCount;
+	double varianceX = mSumXX - mSumX * mSumX / n;
+	double covariance = mSumXY - mSumX * mSumY / n;
+	rSlope = covariance / varianceX;
+	rIntercept = (mSumY - rSlope * mSumX) / n;
+}
+
+void ClockEstimator::Rebase()
+{
+	// Oldest batch becomes reference
+	unsigned int capacity = (unsigned int)mIndices.size();
+	unsigned int oldest = (mNext + capacity - mCount) % capacity;
+	mReferenceIndex = mIndices[oldest];
+	mReferenceTime = mTimes[oldest];
+
+	// Recompute sums
+	mSumX = mSumY = mSumXX = mSumXY = mSumYY = 0.0;
+	for (unsigned int i = 0; i < mCount; i++)
+	{
+		unsigned int idx = (oldest + i) % capacity;
+		double x = mIndices[idx] - mReferenceIndex;
+		double y = mTimes[idx] - mReferenceTime;
+		mSumX += x;
+		mSumY += y;
+		mSumXX += x * x;
+		mSumXY += x * y;
+		mSumYY += y * y;
+	}
+	mAddedSinceRebase = 0;
+}
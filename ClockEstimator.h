@@ -0,0 +1,85 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Online estimation of the relation between the sample counter of a device
+// and lsl::local_clock(). A line is fitted through (sample index, arrival time)
+// pairs of a rolling window of batches. Its slope gives the effective sample
+// rate, its intercept the clock offset and the residuals the jitter. Sums of
+// the fit are updated in constant time per batch.
+
+#ifndef CLOCK_ESTIMATOR_H_
+#define CLOCK_ESTIMATOR_H_
+
+#include <vector>
+
+class ClockEstimator
+{
+public:
+
+	// Constructor with count of batches kept in window
+	ClockEstimator(unsigned int windowSize);
+
+	// Add arrival of batch, with index of its newest sample since start of acquisition
+	void Add(double sampleIndex, double arrivalTime);
+
+	// Forget all batches, e.g. when sample counting starts over
+	void Reset();
+
+	// Whether enough batches are in window for estimation
+	bool IsValid() const;
+
+	// Estimated rate in samples per second
+	double GetEffectiveRate() const;
+
+	// Estimated local clock time of sample index zero
+	double GetOffset() const;
+
+	// Standard deviation of arrival times around the fitted line in seconds
+	double GetJitter() const;
+
+	// Count of batches in window
+	unsigned int GetCount() const { return mCount; }
+
+private:
+
+	// Fit line through window. Slope in seconds per sample, intercept relative to reference
+	void Fit(double& rSlope, double& rIntercept) const;
+
+	// Recompute sums relative to oldest batch, keeping them small
+	void Rebase();
+
+	// Members
+	std::vector<double> mIndices; // ring of sample indices
+	std::vector<double> mTimes; // ring of arrival times
+	unsigned int mNext = 0; // position for next batch in ring
+	unsigned int mCount = 0; // count of batches in ring
+	unsigned int mAddedSinceRebase = 0;
+	double mReferenceIndex = 0.0; // sums are relative to this point
+	double mReferenceTime = 0.0;
+	double mSumX = 0.0;
+	double mSumY = 0.0;
+	double mSumXX = 0.0;
+	double mSumXY = 0.0;
+	double mSumYY = 0.0;
+};
+
+#endif // CLOCK_ESTIMATOR_H_
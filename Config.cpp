@@ -0,0 +1,145 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "Config.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+
+// Remove whitespace at both ends of string
+static std::string Trim(const std::string& rString)
+{
+	size_t begin = 0;
+	size_t end = rString.size();
+	while (begin < end && std::isspace((unsigned char)rString[begin])) { begin++; }
+	while (end > begin && std::isspace((unsigned char)rString[end - 1])) { end--; }
+	return rString.substr(begin, end - begin);
+}
+
+bool Config::Load(const std::string& rFilepath)
+{
+	std::ifstream file(rFilepath);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	// Go over lines and extract key value pairs
+	std::string line;
+	while (std::getline(file, line))
+	{
+		line = Trim(line);
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+		size_t separator = line.find('=');
+		if (separator == std::string::npos)
+		{
+			continue;
+		}
+		Set(Trim(line.substr(0, separator)), Trim(line.substr(separator + 1)));
+	}
+	return true;
+}
+
+void Config::Set(const std::string& rKey, const std::string& rValue)
+{
+	mValues[rKey] = rValue;
+}
+
+bool Config::Has(const std::string& rKey) const
+{
+	return mValues.find(rKey) != mValues.end();
+}
+
+int Config::GetInt(const std::string& rKey, int defaultValue) const
+{
+	auto it = mValues.find(rKey);
+	if (it == mValues.end() || it->second.empty())
+	{
+		return defaultValue;
+	}
+	return std::atoi(it->second.c_str());
+}
+
+double Config::GetDouble(const std::string& rKey, double defaultValue) const
+{
+	auto it = mValues.find(rKey);
+	if (it == mValues.end() || it->second.empty())
+	{
+		return defaultValue;
+	}
+	return std::atof(it->second.c_str());
+}
+
+bool Config::GetBool(const std::string& rKey, bool defaultValue) const
+{
+	auto it = mValues.find(rKey);
+	if (it == mValues.end() || it->second.empty())
+	{
+		return defaultValue;
+	}
+	std::string value = it->second;
+	std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+	return value == "1" || value == "true" || value == "yes" || value == "on";
+}
+
+std::string Config::GetString(const std::string& rKey, const std::string& rDefaultValue) const
+{
+	auto it = mValues.find(rKey);
+	if (it == mValues.end())
+	{
+		return rDefaultValue;
+	}
+	return it->second;
+}
+
+std::vector<std::string> Config::GetList(const std::string& rKey) const
+{
+	std::vector<std::string> list;
+	auto it = mValues.find(rKey);
+	if (it == mValues.end())
+	{
+		return list;
+	}
+
+	// Split at commas
+	size_t begin = 0;
+	while (begin <= it->second.size())
+	{
+		size_t end = it->second.find(',', begin);
+		if (end == std::string::npos)
+		{
+			end = it->second.size();
+		}
+		std::string item = Trim(it->second.substr(begin, end - begin));
+		if (!item.empty())
+		{
+			list.push_back(item);
+		}
+		begin = end + 1;
+	}
+	return list;
+}
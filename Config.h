@@ -0,0 +1,62 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Startup configuration, read from a simple "key = value" text file. Lines
+// starting with '#' are comments. Keys which are not present keep the default
+// value given by the caller.
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+class Config
+{
+public:
+
+	// Load configuration from file. Returns false when file could not be opened
+	bool Load(const std::string& rFilepath);
+
+	// Set single value, overriding the file
+	void Set(const std::string& rKey, const std::string& rValue);
+
+	// Check whether key has been set
+	bool Has(const std::string& rKey) const;
+
+	// Getters with fallback to default value
+	int GetInt(const std::string& rKey, int defaultValue) const;
+	double GetDouble(const std::string& rKey, double defaultValue) const;
+	bool GetBool(const std::string& rKey, bool defaultValue) const;
+	std::string GetString(const std::string& rKey, const std::string& rDefaultValue) const;
+
+	// Comma separated list of values, empty when key is not set
+	std::vector<std::string> GetList(const std::string& rKey) const;
+
+private:
+
+	// Values as strings, parsed on access
+	std::map<std::string, std::string> mValues;
+};
+
+#endif // CONFIG_H_
@@ -0,0 +1,64 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Cached check whether an outlet has consumers. Asking LabStreamingLayer for
+// every block is not free, so the answer is refreshed only periodically.
+// Work for outlets without consumers is skipped. Stages feeding an outlet are
+// reset by their pipeline when it resumes, so they start over with fresh
+// state. The gate is updated by one thread, but may be read by others.
+
+#ifndef CONSUMER_GATE_H_
+#define CONSUMER_GATE_H_
+
+#include "lsl_cpp.h"
+
+#include <atomic>
+
+// Defines
+const double consumerCheckInterval = 0.25; // seconds between checks for consumers
+
+class ConsumerGate
+{
+public:
+
+	// Update whether outlet has consumers, at most once per check interval. Returns whether gate is open
+	bool Update(lsl::stream_outlet& rOutlet, double now)
+	{
+		if (now >= mNextCheck)
+		{
+			mOpen = rOutlet.have_consumers();
+			mNextCheck = now + consumerCheckInterval;
+		}
+		return mOpen;
+	}
+
+	// Whether outlet has consumers, as of last update
+	bool IsOpen() const { return mOpen; }
+
+private:
+
+	// Members
+	double mNextCheck = 0.0;
+	std::atomic<bool> mOpen{ false };
+};
+
+#endif // CONSUMER_GATE_H_
@@ -0,0 +1,55 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "DeviceProfile.h"
+#include "IedkErrorCode.h"
+
+#include <stdexcept>
+
+// Descriptors of all profiles
+static const DeviceDescriptor epocDescriptor = MakeDeviceDescriptor<EpocProfile>();
+static const DeviceDescriptor epocPlus256Descriptor = MakeDeviceDescriptor<EpocPlus256Profile>();
+static const DeviceDescriptor insightDescriptor = MakeDeviceDescriptor<InsightProfile>();
+
+const DeviceDescriptor& SelectDevice(EngineBackend& rEngine, unsigned int userID, const std::string& rOverride)
+{
+	// Explicit selection
+	if (rOverride == "epoc") { return epocDescriptor; }
+	if (rOverride == "epocplus256") { return epocPlus256Descriptor; }
+	if (rOverride == "insight") { return insightDescriptor; }
+	if (rOverride != "auto")
+	{
+		throw std::runtime_error("Unknown device profile: " + rOverride + ", valid are auto, epoc, epocplus256 and insight");
+	}
+
+	// Ask headset about its configuration. EPOC mode is 1 for EPOC+, EEG rate is 1 for 256 Hz
+	unsigned int epocMode = 0;
+	unsigned int eegRate = 0;
+	if (rEngine.GetHeadsetSettings(userID, epocMode, eegRate) == EDK_OK)
+	{
+		if (epocMode == 1 && eegRate == 1)
+		{
+			return epocPlus256Descriptor;
+		}
+	}
+	return epocDescriptor;
+}
@@ -0,0 +1,191 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Device profiles. Each supported headset is a type carrying its channels,
+// labels, unit and sample rate as compile-time constants. Acquisition is a
+// template on the profile, so the transpose from the channel buffers of the
+// SDK into interleaved samples is unrolled for the channel count of the
+// device. At runtime, the profile of the connected headset is selected and
+// used through a DeviceDescriptor.
+
+#ifndef DEVICE_PROFILE_H_
+#define DEVICE_PROFILE_H_
+
+#include "EngineBackend.h"
+#include "SampleBlock.h"
+
+#include <string>
+#include <vector>
+
+// ################
+// ### PROFILES ###
+// ################
+
+// EPOC and EPOC+ in 128 Hz mode
+struct EpocProfile
+{
+	static const unsigned int channelCount = 14;
+	static const int sampleRate = 128;
+	static const char* Name() { return "EPOC"; }
+	static const char* Unit() { return "microvolts"; }
+	static const IEE_DataChannel_t* Channels()
+	{
+		static const IEE_DataChannel_t channels[channelCount] =
+		{
+			IED_AF3, IED_F7, IED_F3, IED_FC5, IED_T7, IED_P7, IED_O1,
+			IED_O2, IED_P8, IED_T8, IED_FC6, IED_F4, IED_F8, IED_AF4
+		};
+		return channels;
+	}
+	static const char* const* Labels()
+	{
+		static const char* const labels[channelCount] =
+		{
+			"AF3", "F7", "F3", "FC5", "T7", "P7", "O1",
+			"O2", "P8", "T8", "FC6", "F4", "F8", "AF4"
+		};
+		return labels;
+	}
+};
+
+// EPOC+ in 256 Hz mode, same channels as EPOC
+struct EpocPlus256Profile : public EpocProfile
+{
+	static const int sampleRate = 256;
+	static const char* Name() { return "EPOC+ 256 Hz"; }
+};
+
+// Insight, the SDK reports its Pz electrode in the slot of O1
+struct InsightProfile
+{
+	static const unsigned int channelCount = 5;
+	static const int sampleRate = 128;
+	static const char* Name() { return "Insight"; }
+	static const char* Unit() { return "microvolts"; }
+	static const IEE_DataChannel_t* Channels()
+	{
+		static const IEE_DataChannel_t channels[channelCount] =
+		{
+			IED_AF3, IED_T7, IED_O1, IED_T8, IED_AF4
+		};
+		return channels;
+	}
+	static const char* const* Labels()
+	{
+		static const char* const labels[channelCount] =
+		{
+			"AF3", "T7", "Pz", "T8", "AF4"
+		};
+		return labels;
+	}
+};
+
+// ###############
+// ### KERNELS ###
+// ###############
+
+// Copy one sample from channel buffers into interleaved output, unrolled over channels
+template<unsigned int ChannelIdx, unsigned int ChannelCount>
+struct InterleaveSample
+{
+	static void Run(double* const* pChannels, unsigned int sampleIdx, float* pOutput)
+	{
+		pOutput[ChannelIdx] = (float)pChannels[ChannelIdx][sampleIdx];
+		InterleaveSample<ChannelIdx + 1, ChannelCount>::Run(pChannels, sampleIdx, pOutput);
+	}
+};
+
+template<unsigned int ChannelCount>
+struct InterleaveSample<ChannelCount, ChannelCount>
+{
+	static void Run(double* const*, unsigned int, float*) {}
+};
+
+// Fetch available samples of profile's channels from updated stream into block, stamped backwards
+// from fetch time. Channel data is reusable storage for the buffers the SDK fills. Returns count of samples
+template<typename Profile>
+unsigned int AcquireEEG(EngineBackend& rEngine, unsigned int stream, std::vector<double>& rChannelData, SampleBlock& rBlock, double fetchTime)
+{
+	// Fetch count of samples
+	unsigned int sampleCount = rEngine.GetSampleCount(stream);
+	rBlock.Resize(Profile::channelCount, sampleCount);
+	if (sampleCount == 0)
+	{
+		return 0;
+	}
+
+	// Prepare local buffer for data
+	rChannelData.resize((size_t)Profile::channelCount * sampleCount);
+	double* channelPointers[Profile::channelCount];
+	for (unsigned int i = 0; i < Profile::channelCount; i++)
+	{
+		channelPointers[i] = &rChannelData[(size_t)i * sampleCount];
+	}
+
+	// Fetch data
+	rEngine.GetEEG(stream, Profile::Channels(), Profile::channelCount, channelPointers, sampleCount);
+
+	// Interleave samples for LabStreamingLayer
+	float* pValues = rBlock.values.data();
+	for (unsigned int sampleIdx = 0; sampleIdx < sampleCount; sampleIdx++)
+	{
+		InterleaveSample<0, Profile::channelCount>::Run(channelPointers, sampleIdx, pValues + (size_t)sampleIdx * Profile::channelCount);
+	}
+	rBlock.StampBackwards(fetchTime, Profile::sampleRate);
+	return sampleCount;
+}
+
+// ##################
+// ### DESCRIPTOR ###
+// ##################
+
+// Runtime view on a profile
+struct DeviceDescriptor
+{
+	std::string name;
+	unsigned int channelCount;
+	int sampleRate;
+	std::string unit;
+	std::vector<std::string> labels;
+	unsigned int(*acquire)(EngineBackend&, unsigned int, std::vector<double>&, SampleBlock&, double); // specialized acquisition
+};
+
+// Create descriptor for profile
+template<typename Profile>
+DeviceDescriptor MakeDeviceDescriptor()
+{
+	DeviceDescriptor descriptor;
+	descriptor.name = Profile::Name();
+	descriptor.channelCount = Profile::channelCount;
+	descriptor.sampleRate = Profile::sampleRate;
+	descriptor.unit = Profile::Unit();
+	descriptor.labels.assign(Profile::Labels(), Profile::Labels() + Profile::channelCount);
+	descriptor.acquire = &AcquireEEG<Profile>;
+	return descriptor;
+}
+
+// Select profile of headset connected for user. Override may be "auto", "epoc",
+// "epocplus256" or "insight", where "auto" asks the headset for its settings.
+// Throws runtime error for any other override
+const DeviceDescriptor& SelectDevice(EngineBackend& rEngine, unsigned int userID, const std::string& rOverride);
+
+#endif // DEVICE_PROFILE_H_
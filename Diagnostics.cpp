@@ -0,0 +1,86 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "Diagnostics.h"
+#include "MemoryBounds.h"
+
+// Labels of diagnostics channels, in order of the enumeration
+const char* const diagnosticsLabels[DIAGNOSTICS_CHANNEL_COUNT] =
+{
+	"EFFECTIVE_SRATE",
+	"DRIFT_PPM",
+	"CLOCK_OFFSET",
+	"JITTER",
+	"RING_OVERFLOWS",
+	"RING_UNDERRUNS",
+	"WAKEUP_LATENESS_MEAN",
+	"WAKEUP_LATENESS_MAX",
+	"MISSED_DEADLINES",
+	"ASR_PROCESSING_MAX",
+	"ASR_BUDGET_OVERRUNS",
+	"ASR_REMOVED_COMPONENTS",
+	"PREDICTION_LATENCY_MEAN",
+	"PREDICTION_LATENCY_MAX",
+	"RING_DROPPED_OLDEST",
+	"RING_BLOCKS",
+	"RESIDENT_MEMORY_MIB",
+	"BUFFER_SIZE",
+	"BUFFER_PEAK_FILL",
+	"BUFFER_NEAR_OVERFLOWS",
+	"PIPELINE_LATENCY_MAX",
+	"PIPELINE_DROPPED_BLOCKS",
+	"FINAL"
+};
+
+Diagnostics::Diagnostics(double interval, const Config& rConfig) : mValues(DIAGNOSTICS_CHANNEL_COUNT, 0.0), mInterval(interval)
+{
+	// Start filling information about stream
+	lsl::stream_info streamInfo("EmotivLSL_Diagnostics", "Diagnostics", DIAGNOSTICS_CHANNEL_COUNT, 1.0 / mInterval, lsl::cf_double64, "source_id");
+	streamInfo.desc().append_child_value("manufacturer", "Emotiv");
+
+	// Save information about channels
+	lsl::xml_element channels = streamInfo.desc().append_child("channels");
+	for (unsigned int i = 0; i < DIAGNOSTICS_CHANNEL_COUNT; i++)
+	{
+		channels.append_child("channel")
+			.append_child_value("label", diagnosticsLabels[i]);
+	}
+
+	// Create stream outlet with information header
+	mupOutlet = CreateOutlet(streamInfo, rConfig);
+}
+
+bool Diagnostics::Update(double now)
+{
+	if (now >= mNextPublish)
+	{
+		Publish(now);
+		mNextPublish = now + mInterval;
+		return true;
+	}
+	return false;
+}
+
+void Diagnostics::Publish(double now)
+{
+	mupOutlet->push_sample(mValues, now);
+}
@@ -0,0 +1,95 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Low rate stream with diagnostic values of EmotivLSL. Values are collected
+// during operation and published at a fixed interval on EmotivLSL_Diagnostics.
+
+#ifndef DIAGNOSTICS_H_
+#define DIAGNOSTICS_H_
+
+#include "lsl_cpp.h"
+
+#include "Config.h"
+
+#include <memory>
+
+// Channels of diagnostics stream
+enum DiagnosticsChannel
+{
+	DIAGNOSTICS_EFFECTIVE_RATE, // estimated EEG sample rate in Hz
+	DIAGNOSTICS_DRIFT, // deviation of effective from nominal sample rate in parts per million
+	DIAGNOSTICS_CLOCK_OFFSET, // estimated local clock time of first EEG sample
+	DIAGNOSTICS_JITTER, // standard deviation of batch arrival around clock model in seconds
+	DIAGNOSTICS_RING_OVERFLOWS, // count of EEG blocks dropped because publishing fell behind
+	DIAGNOSTICS_RING_UNDERRUNS, // count of times publishing found no EEG block
+	DIAGNOSTICS_WAKEUP_LATENESS_MEAN, // mean lateness of main loop wakeups since last sample in seconds
+	DIAGNOSTICS_WAKEUP_LATENESS_MAX, // maximal lateness of main loop wakeups since last sample in seconds
+	DIAGNOSTICS_MISSED_DEADLINES, // count of main loop iterations lost to late wakeups since last sample
+	DIAGNOSTICS_ASR_PROCESSING_MAX, // maximal seconds of artifact subspace reconstruction per block since last sample
+	DIAGNOSTICS_ASR_BUDGET_OVERRUNS, // count of blocks exceeding the latency budget of artifact subspace reconstruction
+	DIAGNOSTICS_ASR_REMOVED_COMPONENTS, // count of components removed from latest block
+	DIAGNOSTICS_PREDICTION_LATENCY_MEAN, // mean seconds from newest sample of feature window to prediction since last sample
+	DIAGNOSTICS_PREDICTION_LATENCY_MAX, // maximal seconds from newest sample of feature window to prediction since last sample
+	DIAGNOSTICS_RING_DROPPED_OLDEST, // count of EEG blocks dropped by publishing to make room for newer ones
+	DIAGNOSTICS_RING_BLOCKS, // count of times acquisition waited for publishing
+	DIAGNOSTICS_RESIDENT_MEMORY, // resident memory of process in MiB
+	DIAGNOSTICS_BUFFER_SIZE, // size of SDK buffers in seconds
+	DIAGNOSTICS_BUFFER_PEAK_FILL, // highest fill of EEG buffer per update since last sample, one is full
+	DIAGNOSTICS_BUFFER_NEAR_OVERFLOWS, // count of updates that nearly filled the EEG buffer, probably losing samples
+	DIAGNOSTICS_PIPELINE_LATENCY_MAX, // maximal seconds from handing a block to the pipeline until all its stages are done since last sample
+	DIAGNOSTICS_PIPELINE_DROPPED_BLOCKS, // count of EEG blocks dropped by the pipeline because its stages fell behind
+	DIAGNOSTICS_FINAL, // one for the summary sent at shutdown
+	DIAGNOSTICS_CHANNEL_COUNT
+};
+
+class Diagnostics
+{
+public:
+
+	// Constructor with seconds between samples and configuration of outlet
+	Diagnostics(double interval, const Config& rConfig);
+
+	// Set value of channel, sent with next sample
+	void Set(DiagnosticsChannel channel, double value) { mValues[channel] = value; }
+
+	// Get value of channel
+	double Get(DiagnosticsChannel channel) const { return mValues[channel]; }
+
+	// Whether interval has passed, so the next update publishes
+	bool IsDue(double now) const { return now >= mNextPublish; }
+
+	// Publish sample when interval has passed. Returns whether published
+	bool Update(double now);
+
+	// Publish sample immediately
+	void Publish(double now);
+
+private:
+
+	// Members
+	std::unique_ptr<lsl::stream_outlet> mupOutlet;
+	std::vector<double> mValues;
+	double mInterval;
+	double mNextPublish = 0.0;
+};
+
+#endif // DIAGNOSTICS_H_
@@ -0,0 +1,483 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "EEGChain.h"
+#include "MemoryBounds.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+// Defines
+const int defaultResampleTapsPerPhase = 16; // length of resampling filter per output phase
+const double defaultAsrCalibration = 60.0; // seconds of clean data for calibrating artifact subspace reconstruction
+const double defaultAsrCutoff = 5.0; // standard deviations of component amplitude above which components are removed
+const double defaultAsrWindow = 0.5; // seconds over which the covariance is tracked
+const double defaultAsrLatencyBudget = 0.005; // seconds of processing per block
+const double defaultFeatureWindow = 1.0; // seconds of EEG features are computed over
+const double defaultFeatureHop = 0.1; // seconds between feature vectors
+const std::vector<std::string> defaultFeatureBands = { "4-8", "8-13", "13-30" }; // theta, alpha and beta
+const int defaultPipelineQueue = 16; // blocks waiting for the stages before further ones are dropped
+
+// Input of stage as configured. Only sources and stages putting out EEG of the device may feed others
+static std::string GetStageInput(const Config& rConfig, const std::string& rStage, const std::string& rDefaultInput)
+{
+	std::string input = rConfig.GetString("pipelineInput." + rStage, rDefaultInput);
+	if (input != pipelineSourceRaw && input != pipelineSourceMain && input != "rereferenced" && input != "clean")
+	{
+		throw std::runtime_error("Input of pipeline stage " + rStage + " must be raw, main, rereferenced or clean: " + input);
+	}
+	return input;
+}
+
+EEGChain::EEGChain(const DeviceDescriptor& rDevice, const Config& rConfig, std::shared_ptr<WorkStealingPool> spPool) :
+	mrDevice(rDevice),
+	mPipeline(spPool, (unsigned int)std::max(1, rConfig.GetInt("pipelineQueue", defaultPipelineQueue)))
+{
+	// Information about main stream
+	lsl::stream_info streamInfoEEG = CreateEEGStreamInfo("EmotivLSL_EEG", mrDevice, mrDevice.sampleRate);
+
+	// ############################################
+	// ### RE-REFERENCED EEG STREAM PREPARATION ###
+	// ############################################
+
+	// Re-referencing is either "car" for common average or a list of reference channel labels
+	std::vector<std::string> referenceLabels = rConfig.GetList("rereference");
+	if (!referenceLabels.empty() && referenceLabels[0] != "off")
+	{
+		// Translate labels to channel indices
+		std::vector<unsigned int> referenceChannels;
+		if (referenceLabels[0] != "car")
+		{
+			for (const auto& rReferenceLabel : referenceLabels)
+			{
+				auto it = std::find(mrDevice.labels.begin(), mrDevice.labels.end(), rReferenceLabel);
+				if (it == mrDevice.labels.end())
+				{
+					throw std::runtime_error("Unknown reference channel for " + mrDevice.name + ": " + rReferenceLabel);
+				}
+				referenceChannels.push_back((unsigned int)(it - mrDevice.labels.begin()));
+			}
+		}
+		mupRereference = std::unique_ptr<Rereference>(new Rereference(mrDevice.channelCount, referenceChannels));
+		std::string referenceDescription = referenceChannels.empty() ? "common_average" : rConfig.GetString("rereference", "");
+
+		// Either replace the main EEG stream or publish on a separate one
+		if (rConfig.GetString("rereferenceOutlet", "main") == "separate")
+		{
+			lsl::stream_info streamInfoEEGRereferenced = CreateEEGStreamInfo("EmotivLSL_EEG_Rereferenced", mrDevice, mrDevice.sampleRate);
+			streamInfoEEGRereferenced.desc().append_child("reference")
+				.append_child_value("label", referenceDescription);
+			mupOutletRereferenced = CreateOutlet(streamInfoEEGRereferenced, rConfig);
+			mPipeline.AddStage("rereferenced", GetStageInput(rConfig, "rereferenced", pipelineSourceRaw),
+				[this](const SampleBlock& rInput) -> const SampleBlock*
+				{
+					mupRereference->Process(rInput, mRereferencedBlock);
+					if (mGateRereferenced.IsOpen())
+					{
+						mupOutletRereferenced->push_chunk_multiplexed(mRereferencedBlock.values, mRereferencedBlock.timestamps);
+					}
+					return &mRereferencedBlock;
+				},
+				[this]() { return mGateRereferenced.IsOpen(); });
+		}
+		else
+		{
+			streamInfoEEG.desc().append_child("reference")
+				.append_child_value("label", referenceDescription);
+		}
+		std::cout << "Re-referencing EEG to " << referenceDescription << std::endl;
+	}
+
+	// ##############################
+	// ### EEG STREAM PREPARATION ###
+	// ##############################
+
+	// Create stream outlet with information header
+	mupOutlet = CreateOutlet(streamInfoEEG, rConfig);
+
+	// ##########################################
+	// ### SPATIALLY FILTERED EEG PREPARATION ###
+	// ##########################################
+
+	// Every listed filter is read from the file given by its own key and gets its own outlet
+	std::vector<SpatialFilter*> spatialFilters;
+	for (const auto& rName : rConfig.GetList("spatialFilters"))
+	{
+		mSpatialFilters.push_back(std::unique_ptr<SpatialFilter>(
+			new SpatialFilter(rName, rConfig.GetString("spatialFilter." + rName, rName + ".txt"), mrDevice, rConfig)));
+		SpatialFilter* pSpatialFilter = mSpatialFilters.back().get();
+		spatialFilters.push_back(pSpatialFilter);
+		mPipeline.AddStage("spatial." + rName, GetStageInput(rConfig, "spatial." + rName, pipelineSourceRaw),
+			[pSpatialFilter](const SampleBlock& rInput) -> const SampleBlock* { pSpatialFilter->Publish(rInput); return nullptr; },
+			[pSpatialFilter]() { return pSpatialFilter->IsOpen(); });
+	}
+	if (!spatialFilters.empty())
+	{
+		mupSpatialFilterWatcher = std::unique_ptr<SpatialFilterWatcher>(new SpatialFilterWatcher(spatialFilters));
+	}
+
+	// ####################################
+	// ### CLEAN EEG STREAM PREPARATION ###
+	// ####################################
+
+	// Artifact subspace reconstruction, by default on the EEG as acquired
+	if (rConfig.GetBool("asr", false))
+	{
+		mupAsr = std::unique_ptr<ArtifactSubspaceReconstruction>(new ArtifactSubspaceReconstruction(
+			mrDevice.channelCount, mrDevice.sampleRate,
+			rConfig.GetDouble("asrCalibration", defaultAsrCalibration),
+			rConfig.GetDouble("asrCutoff", defaultAsrCutoff),
+			rConfig.GetDouble("asrWindow", defaultAsrWindow),
+			rConfig.GetDouble("asrLatencyBudget", defaultAsrLatencyBudget)));
+		lsl::stream_info streamInfoEEGClean = CreateEEGStreamInfo("EmotivLSL_EEG_Clean", mrDevice, mrDevice.sampleRate);
+		streamInfoEEGClean.desc().append_child("asr")
+			.append_child_value("calibration", std::to_string(rConfig.GetDouble("asrCalibration", defaultAsrCalibration)))
+			.append_child_value("cutoff", std::to_string(rConfig.GetDouble("asrCutoff", defaultAsrCutoff)));
+		mupOutletClean = CreateOutlet(streamInfoEEGClean, rConfig);
+		mPipeline.AddStage("clean", GetStageInput(rConfig, "clean", pipelineSourceRaw),
+			[this](const SampleBlock& rInput) -> const SampleBlock*
+			{
+				// Cleaned EEG exists once calibration is done
+				if (!mupAsr->Process(rInput, mCleanBlock))
+				{
+					return nullptr;
+				}
+				if (mGateClean.IsOpen())
+				{
+					mupOutletClean->push_chunk_multiplexed(mCleanBlock.values, mCleanBlock.timestamps);
+				}
+				return &mCleanBlock;
+			},
+			[this]() { return mGateClean.IsOpen(); });
+		std::cout << "Cleaning EEG by artifact subspace reconstruction after " << rConfig.GetDouble("asrCalibration", defaultAsrCalibration)
+			<< " s of calibration" << std::endl;
+	}
+
+	// ##################################
+	// ### FEATURE STREAM PREPARATION ###
+	// ##################################
+
+	// Feature vectors over sliding window, by default of the EEG as acquired, for the outlet or the classifier
+	std::string classifierModel = rConfig.GetString("classifierModel", "");
+	if (rConfig.GetBool("features", false) || !classifierModel.empty())
+	{
+		std::vector<std::string> bands = rConfig.GetList("featureBands");
+		if (bands.empty())
+		{
+			bands = defaultFeatureBands;
+		}
+		unsigned int windowLength = (unsigned int)(rConfig.GetDouble("featureWindow", defaultFeatureWindow) * mrDevice.sampleRate);
+		unsigned int hop = std::max(1u, (unsigned int)(rConfig.GetDouble("featureHop", defaultFeatureHop) * mrDevice.sampleRate));
+		mupFeatureExtractor = std::unique_ptr<FeatureExtractor>(new FeatureExtractor(
+			mrDevice.channelCount, mrDevice.sampleRate, windowLength, hop, ParseFrequencyBands(bands)));
+
+		// Stream information with one channel per feature
+		double featureRate = (double)mrDevice.sampleRate / hop;
+		lsl::stream_info streamInfoFeatures("EmotivLSL_Features", "Features", mupFeatureExtractor->GetFeatureCount(),
+			(double)mrDevice.sampleRate / hop, lsl::cf_float32, "source_id");
+		streamInfoFeatures.desc().append_child_value("manufacturer", "Emotiv");
+		streamInfoFeatures.desc().append_child_value("model", mrDevice.name);
+		lsl::xml_element channels = streamInfoFeatures.desc().append_child("channels");
+		for (const auto& rLabel : mupFeatureExtractor->GetLabels(mrDevice.labels))
+		{
+			channels.append_child("channel")
+				.append_child_value("label", rLabel)
+				.append_child_value("type", "Feature");
+		}
+		streamInfoFeatures.desc().append_child("features")
+			.append_child_value("window_samples", std::to_string(windowLength))
+			.append_child_value("hop_samples", std::to_string(hop));
+		if (rConfig.GetBool("features", false))
+		{
+			mupOutletFeatures = CreateOutlet(streamInfoFeatures, rConfig);
+			std::cout << "Publishing " << mupFeatureExtractor->GetFeatureCount() << " features every " << hop << " samples" << std::endl;
+		}
+
+		// Feature vectors of the hops completed within the block, for the outlet and the classifier
+		mPipeline.AddStage("features", GetStageInput(rConfig, "features", pipelineSourceRaw),
+			[this](const SampleBlock& rInput) -> const SampleBlock*
+			{
+				mupFeatureExtractor->Process(rInput, mFeatureBlock);
+				if (mFeatureBlock.SampleCount() == 0)
+				{
+					return nullptr;
+				}
+				if (mupOutletFeatures && mGateFeatures.IsOpen())
+				{
+					mupOutletFeatures->push_chunk_multiplexed(mFeatureBlock.values, mFeatureBlock.timestamps);
+				}
+				return &mFeatureBlock;
+			},
+			[this]() { return mupOutletFeatures && mGateFeatures.IsOpen(); },
+			[this]() { mupFeatureExtractor->Reset(); });
+
+		// #####################################
+		// ### PREDICTION STREAM PREPARATION ###
+		// #####################################
+
+		// Linear model on the features, publishing probability of every class
+		if (!classifierModel.empty())
+		{
+			mupClassifier = std::unique_ptr<LinearClassifier>(new LinearClassifier(classifierModel, mupFeatureExtractor->GetFeatureCount()));
+			lsl::stream_info streamInfoPrediction("EmotivLSL_Prediction", "Prediction", mupClassifier->GetClassCount(), featureRate, lsl::cf_float32, "source_id");
+			streamInfoPrediction.desc().append_child_value("manufacturer", "Emotiv");
+			streamInfoPrediction.desc().append_child_value("model", mrDevice.name);
+			lsl::xml_element classChannels = streamInfoPrediction.desc().append_child("channels");
+			for (const auto& rLabel : mupClassifier->GetClassLabels())
+			{
+				classChannels.append_child("channel")
+					.append_child_value("label", rLabel)
+					.append_child_value("type", "Probability");
+			}
+			streamInfoPrediction.desc().append_child("classifier")
+				.append_child_value("file", classifierModel);
+			mupOutletPrediction = CreateOutlet(streamInfoPrediction, rConfig);
+
+			// Prediction per feature vector, latency measured from newest sample of its window
+			mPipeline.AddStage("prediction", "features",
+				[this](const SampleBlock& rInput) -> const SampleBlock*
+				{
+					unsigned int vectorCount = rInput.SampleCount();
+					unsigned int classCount = mupClassifier->GetClassCount();
+					mPredictionBlock.Resize(classCount, vectorCount);
+					for (unsigned int vectorIdx = 0; vectorIdx < vectorCount; vectorIdx++)
+					{
+						mupClassifier->Predict(&rInput.values[(size_t)vectorIdx * rInput.channelCount],
+							&mPredictionBlock.values[(size_t)vectorIdx * classCount]);
+					}
+					mPredictionBlock.timestamps = rInput.timestamps;
+					mupOutletPrediction->push_chunk_multiplexed(mPredictionBlock.values, mPredictionBlock.timestamps);
+					double pushTime = lsl::local_clock();
+					for (double timestamp : mPredictionBlock.timestamps)
+					{
+						mPredictionLatency.Add(pushTime - timestamp);
+					}
+					return nullptr;
+				},
+				[this]() { return mGatePrediction.IsOpen(); });
+			std::cout << "Predicting " << mupClassifier->GetClassCount() << " classes with model from " << classifierModel << std::endl;
+		}
+	}
+
+	// ##################################
+	// ### PREVIEW STREAM PREPARATION ###
+	// ##################################
+
+	// Minimum and maximum of each channel per bucket, for dashboards
+	double previewRate = rConfig.GetDouble("previewRate", 0.0);
+	if (previewRate > 0.0)
+	{
+		unsigned int bucketLength = std::max(1u, (unsigned int)(mrDevice.sampleRate / previewRate + 0.5));
+		mupPreview = std::unique_ptr<MinMaxDecimator>(new MinMaxDecimator(mrDevice.channelCount, bucketLength));
+		lsl::stream_info streamInfoPreview("EmotivLSL_EEG_Preview", "EEG", 2 * mrDevice.channelCount, (double)mrDevice.sampleRate / bucketLength, lsl::cf_float32, "source_id");
+		streamInfoPreview.desc().append_child_value("manufacturer", "Emotiv");
+		streamInfoPreview.desc().append_child_value("model", mrDevice.name);
+		lsl::xml_element channels = streamInfoPreview.desc().append_child("channels");
+		for (const auto& rLabel : mrDevice.labels)
+		{
+			channels.append_child("channel")
+				.append_child_value("label", rLabel + "_MIN")
+				.append_child_value("unit", mrDevice.unit)
+				.append_child_value("type", "EEG");
+			channels.append_child("channel")
+				.append_child_value("label", rLabel + "_MAX")
+				.append_child_value("unit", mrDevice.unit)
+				.append_child_value("type", "EEG");
+		}
+		streamInfoPreview.desc().append_child("preview")
+			.append_child_value("bucket_samples", std::to_string(bucketLength));
+		mupOutletPreview = CreateOutlet(streamInfoPreview, rConfig);
+		mPipeline.AddStage("preview", GetStageInput(rConfig, "preview", pipelineSourceRaw),
+			[this](const SampleBlock& rInput) -> const SampleBlock*
+			{
+				mupPreview->Process(rInput, mPreviewBlock);
+				if (mPreviewBlock.SampleCount() > 0)
+				{
+					mupOutletPreview->push_chunk_multiplexed(mPreviewBlock.values, mPreviewBlock.timestamps);
+				}
+				return nullptr;
+			},
+			[this]() { return mGatePreview.IsOpen(); },
+			[this]() { mupPreview->Reset(); });
+	}
+
+	// ########################################
+	// ### RESAMPLED EEG STREAM PREPARATION ###
+	// ########################################
+
+	// Resampling is only done when a target rate is configured
+	int resampleRate = rConfig.GetInt("resampleRate", 0);
+	if (resampleRate > 0 && resampleRate != mrDevice.sampleRate)
+	{
+		// Setup resampler
+		unsigned int up = 1;
+		unsigned int down = 1;
+		ReduceRateFraction(mrDevice.sampleRate, resampleRate, up, down);
+		mupResampler = std::unique_ptr<PolyphaseResampler>(
+			new PolyphaseResampler(mrDevice.channelCount, mrDevice.sampleRate, up, down, rConfig.GetInt("resampleTapsPerPhase", defaultResampleTapsPerPhase)));
+
+		// Stream information, same channels as raw EEG
+		lsl::stream_info streamInfoEEGResampled = CreateEEGStreamInfo("EmotivLSL_EEG_Resampled", mrDevice, mupResampler->GetOutputRate());
+
+		// Tell consumers about the filter. Timestamps are corrected by the group delay,
+		// samples arrive by the group delay later than the ones of the raw EEG stream
+		streamInfoEEGResampled.desc().append_child("resampling")
+			.append_child_value("source_rate", std::to_string(mrDevice.sampleRate))
+			.append_child_value("up", std::to_string(up))
+			.append_child_value("down", std::to_string(down))
+			.append_child_value("group_delay", std::to_string(mupResampler->GetGroupDelay()));
+
+		// Create stream outlet with information header
+		mupOutletResampled = CreateOutlet(streamInfoEEGResampled, rConfig);
+		mPipeline.AddStage("resampled", GetStageInput(rConfig, "resampled", pipelineSourceMain),
+			[this](const SampleBlock& rInput) -> const SampleBlock*
+			{
+				mupResampler->Process(rInput, mResampledBlock);
+				mupOutletResampled->push_chunk_multiplexed(mResampledBlock.values, mResampledBlock.timestamps);
+				return nullptr;
+			},
+			[this]() { return mGateResampled.IsOpen(); },
+			[this]() { mupResampler->Reset(); });
+		std::cout << "Resampling EEG to " << mupResampler->GetOutputRate() << " Hz with group delay of "
+			<< mupResampler->GetGroupDelay() * 1000.0 << " ms" << std::endl;
+	}
+
+	// ###################################
+	// ### PIPELINE TIMING PREPARATION ###
+	// ###################################
+
+	// Stages are known now, so inputs can be resolved
+	mPipeline.Finalize();
+	if (mPipeline.GetStageCount() > 0)
+	{
+		// Mean and maximum of processing time per block of every stage
+		lsl::stream_info streamInfoTiming("EmotivLSL_Pipeline", "Diagnostics", 2 * mPipeline.GetStageCount(), lsl::IRREGULAR_RATE, lsl::cf_double64, "source_id");
+		streamInfoTiming.desc().append_child_value("manufacturer", "Emotiv");
+		streamInfoTiming.desc().append_child_value("model", mrDevice.name);
+		lsl::xml_element channels = streamInfoTiming.desc().append_child("channels");
+		for (unsigned int stageIdx = 0; stageIdx < mPipeline.GetStageCount(); stageIdx++)
+		{
+			channels.append_child("channel")
+				.append_child_value("label", mPipeline.GetStageName(stageIdx) + "_MEAN")
+				.append_child_value("unit", "seconds");
+			channels.append_child("channel")
+				.append_child_value("label", mPipeline.GetStageName(stageIdx) + "_MAX")
+				.append_child_value("unit", "seconds");
+		}
+		mupOutletTiming = CreateOutlet(streamInfoTiming, rConfig);
+		mTimingSample.resize(2 * mPipeline.GetStageCount());
+		std::cout << "Running " << mPipeline.GetStageCount() << " pipeline stages "
+			<< (spPool ? "on " + std::to_string(spPool->GetThreadCount()) + " threads" : std::string("after publishing")) << std::endl;
+	}
+}
+
+bool EEGChain::UpdateConsumers(double now)
+{
+	bool open = mGate.Update(*mupOutlet, now);
+	if (mupOutletRereferenced)
+	{
+		open |= mGateRereferenced.Update(*mupOutletRereferenced, now);
+	}
+	if (mupOutletResampled)
+	{
+		open |= mGateResampled.Update(*mupOutletResampled, now);
+	}
+	if (mupOutletClean)
+	{
+		open |= mGateClean.Update(*mupOutletClean, now);
+	}
+	if (mupOutletPreview)
+	{
+		open |= mGatePreview.Update(*mupOutletPreview, now);
+	}
+	if (mupOutletFeatures)
+	{
+		open |= mGateFeatures.Update(*mupOutletFeatures, now);
+	}
+	if (mupOutletPrediction)
+	{
+		open |= mGatePrediction.Update(*mupOutletPrediction, now);
+	}
+	for (auto& rupSpatialFilter : mSpatialFilters)
+	{
+		open |= rupSpatialFilter->UpdateConsumers(now);
+	}
+	return open;
+}
+
+void EEGChain::Publish(const SampleBlock& rBlock)
+{
+	// Re-reference for the main stream
+	const SampleBlock* pMainBlock = &rBlock;
+	if (mupRereference && !mupOutletRereferenced)
+	{
+		mupRereference->Process(rBlock, mMainBlock);
+		pMainBlock = &mMainBlock;
+	}
+
+	// Output samples to LabStreamingLayer before any derived stream
+	if (mGate.IsOpen())
+	{
+		mupOutlet->push_chunk_multiplexed(pMainBlock->values, pMainBlock->timestamps);
+	}
+
+	// Derived streams from copies of the blocks
+	mPipeline.Submit(rBlock, *pMainBlock);
+}
+
+void EEGChain::PublishPipelineTiming()
+{
+	if (!mupOutletTiming)
+	{
+		return;
+	}
+	for (unsigned int stageIdx = 0; stageIdx < mPipeline.GetStageCount(); stageIdx++)
+	{
+		LatencyInterval timing = mPipeline.GetStageTiming(stageIdx).TakeInterval();
+		mTimingSample[2 * stageIdx] = timing.mean;
+		mTimingSample[2 * stageIdx + 1] = timing.max;
+	}
+	if (mupOutletTiming->have_consumers())
+	{
+		mupOutletTiming->push_sample(mTimingSample);
+	}
+}
+
+lsl::stream_info CreateEEGStreamInfo(const std::string& rName, const DeviceDescriptor& rDevice, double sampleRate)
+{
+	// Start filling information about stream
+	lsl::stream_info streamInfo(rName, "EEG", rDevice.channelCount, sampleRate, lsl::cf_float32, "source_id");
+	streamInfo.desc().append_child_value("manufacturer", "Emotiv");
+	streamInfo.desc().append_child_value("model", rDevice.name);
+
+	// Save information about channels
+	lsl::xml_element channels = streamInfo.desc().append_child("channels");
+	for (const auto& rLabel : rDevice.labels)
+	{
+		channels.append_child("channel")
+			.append_child_value("label", rLabel)
+			.append_child_value("unit", rDevice.unit)
+			.append_child_value("type", "EEG");
+	}
+	return streamInfo;
+}
@@ -0,0 +1,125 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Outlets and processing stages of the EEG of one device. The chain is
+// created when the device is known, since channel layout and sample rate of
+// all EEG streams depend on it. The main stream is pushed first, all derived
+// streams are produced by stages of a pipeline, which may run on a pool.
+
+#ifndef EEG_CHAIN_H_
+#define EEG_CHAIN_H_
+
+#include "lsl_cpp.h"
+
+#include "Asr.h"
+#include "Config.h"
+#include "ConsumerGate.h"
+#include "DeviceProfile.h"
+#include "FeatureExtractor.h"
+#include "LatencyMonitor.h"
+#include "LinearClassifier.h"
+#include "MinMaxDecimator.h"
+#include "Pipeline.h"
+#include "PolyphaseResampler.h"
+#include "Rereference.h"
+#include "SampleBlock.h"
+#include "SpatialFilter.h"
+#include "WorkStealingPool.h"
+
+#include <memory>
+#include <vector>
+
+class EEGChain
+{
+public:
+
+	// Constructor, creates outlets and stages for device as configured. Stages run on pool, if any
+	EEGChain(const DeviceDescriptor& rDevice, const Config& rConfig, std::shared_ptr<WorkStealingPool> spPool);
+
+	// Check outlets for consumers. Returns false when no outlet has consumers,
+	// so acquisition can be skipped altogether. Called by acquisition, while
+	// publishing may happen on another thread
+	bool UpdateConsumers(double now);
+
+	// Process samples acquired from device and push them to the outlets with
+	// consumers. Block is left untouched, as subscribers may view it concurrently.
+	// Derived streams may be pushed after returning
+	void Publish(const SampleBlock& rBlock);
+
+	// Push processing time of every stage since last call, if there are consumers, and start over
+	void PublishPipelineTiming();
+
+	// Device the chain has been created for
+	const DeviceDescriptor& GetDevice() const { return mrDevice; }
+
+	// Artifact subspace reconstruction stage, null if not configured
+	ArtifactSubspaceReconstruction* GetAsr() const { return mupAsr.get(); }
+
+	// Latency from newest sample of a feature window to its published prediction
+	LatencyMonitor& GetPredictionLatency() { return mPredictionLatency; }
+
+	// Stages of derived streams
+	Pipeline& GetPipeline() { return mPipeline; }
+
+private:
+
+	// Members
+	const DeviceDescriptor& mrDevice;
+	std::unique_ptr<lsl::stream_outlet> mupOutlet;
+	std::unique_ptr<Rereference> mupRereference;
+	std::unique_ptr<lsl::stream_outlet> mupOutletRereferenced;
+	std::unique_ptr<PolyphaseResampler> mupResampler;
+	std::unique_ptr<lsl::stream_outlet> mupOutletResampled;
+	ConsumerGate mGate;
+	ConsumerGate mGateRereferenced;
+	ConsumerGate mGateResampled;
+	SampleBlock mMainBlock;
+	SampleBlock mRereferencedBlock;
+	SampleBlock mResampledBlock;
+	std::unique_ptr<ArtifactSubspaceReconstruction> mupAsr;
+	std::unique_ptr<lsl::stream_outlet> mupOutletClean;
+	ConsumerGate mGateClean;
+	SampleBlock mCleanBlock;
+	std::unique_ptr<FeatureExtractor> mupFeatureExtractor;
+	std::unique_ptr<lsl::stream_outlet> mupOutletFeatures;
+	ConsumerGate mGateFeatures;
+	SampleBlock mFeatureBlock;
+	std::unique_ptr<LinearClassifier> mupClassifier;
+	std::unique_ptr<lsl::stream_outlet> mupOutletPrediction;
+	ConsumerGate mGatePrediction;
+	SampleBlock mPredictionBlock;
+	LatencyMonitor mPredictionLatency;
+	std::unique_ptr<MinMaxDecimator> mupPreview;
+	std::unique_ptr<lsl::stream_outlet> mupOutletPreview;
+	ConsumerGate mGatePreview;
+	SampleBlock mPreviewBlock;
+	std::vector<std::unique_ptr<SpatialFilter> > mSpatialFilters;
+	std::unique_ptr<SpatialFilterWatcher> mupSpatialFilterWatcher;
+	std::unique_ptr<lsl::stream_outlet> mupOutletTiming;
+	std::vector<double> mTimingSample;
+	Pipeline mPipeline; // last member, so stages are done before anything they use is destroyed
+};
+
+// Create information about EEG stream of device, including channel description
+lsl::stream_info CreateEEGStreamInfo(const std::string& rName, const DeviceDescriptor& rDevice, double sampleRate);
+
+#endif // EEG_CHAIN_H_
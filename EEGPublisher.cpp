@@ -0,0 +1,103 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "EEGPublisher.h"
+
+#include <chrono>
+
+// Defines
+const size_t publisherBatchSize = 4; // maximal count of blocks taken from ring at once
+const long long publisherIdleInMiliseconds = 2; // sleep when ring is empty
+
+EEGPublisher::EEGPublisher(SampleRing& rRing, RingPolicy policy, Watchdog* pWatchdog) : mrRing(rRing), mPolicy(policy), mpWatchdog(pWatchdog)
+{
+	mThread = std::thread(&EEGPublisher::Run, this);
+}
+
+EEGPublisher::~EEGPublisher()
+{
+	Stop();
+}
+
+void EEGPublisher::SetChain(std::shared_ptr<EEGChain> spChain)
+{
+	std::atomic_store(&mspChain, spChain);
+}
+
+void EEGPublisher::Stop()
+{
+	mRunning = false;
+	if (mThread.joinable())
+	{
+		mThread.join();
+	}
+}
+
+void EEGPublisher::Run()
+{
+	if (mpWatchdog)
+	{
+		mpWatchdog->Arm(WATCHDOG_PUBLISHING, lsl::local_clock());
+	}
+
+	// Keep going until stopped and ring is drained
+	while (true)
+	{
+		if (mpWatchdog)
+		{
+			mpWatchdog->Beat(WATCHDOG_PUBLISHING, lsl::local_clock());
+		}
+		// Keep room for the producer, so the newest blocks survive when publishing falls behind
+		if (mPolicy == RING_DROP_OLDEST)
+		{
+			mrRing.DropOldest(mrRing.GetCapacity() / 2);
+		}
+		size_t blockCount = mrRing.Peek(publisherBatchSize);
+		if (blockCount == 0)
+		{
+			if (!mRunning.load())
+			{
+				break;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(publisherIdleInMiliseconds));
+			continue;
+		}
+
+		// Publish blocks with chain of the moment
+		std::shared_ptr<EEGChain> spChain = std::atomic_load(&mspChain);
+		for (size_t blockIdx = 0; blockIdx < blockCount; blockIdx++)
+		{
+			const SampleBlock& rBlock = mrRing.Peeked(blockIdx);
+			if (spChain && rBlock.channelCount == spChain->GetDevice().channelCount)
+			{
+				spChain->Publish(rBlock);
+				mPublishedBlockCount.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		mrRing.Release(blockCount);
+	}
+
+	if (mpWatchdog)
+	{
+		mpWatchdog->Disarm(WATCHDOG_PUBLISHING, lsl::local_clock());
+	}
+}
@@ -0,0 +1,77 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Thread publishing EEG blocks handed over by acquisition through a ring.
+// Processing and pushing to the outlets happen here, so acquisition only
+// copies samples out of the SDK and is never held up by LabStreamingLayer.
+
+#ifndef EEG_PUBLISHER_H_
+#define EEG_PUBLISHER_H_
+
+#include "EEGChain.h"
+#include "SampleRing.h"
+#include "Watchdog.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+class EEGPublisher
+{
+public:
+
+	// Constructor, starts thread consuming from ring. With policy of dropping oldest blocks, blocks
+	// beyond half of the ring are dropped before publishing. Thread beats watchdog, if any
+	EEGPublisher(SampleRing& rRing, RingPolicy policy = RING_DROP_NEWEST, Watchdog* pWatchdog = nullptr);
+
+	// Destructor, stops thread
+	~EEGPublisher();
+
+	// Chain to publish to, may be exchanged while running. Blocks not matching the
+	// device of the chain are dropped
+	void SetChain(std::shared_ptr<EEGChain> spChain);
+
+	// Stop thread after remaining blocks have been published
+	void Stop();
+
+	// Handle of thread, e.g. for setting its priority
+	std::thread::native_handle_type GetNativeHandle() { return mThread.native_handle(); }
+
+	// Count of blocks published so far
+	unsigned long long GetPublishedBlockCount() const { return mPublishedBlockCount.load(std::memory_order_relaxed); }
+
+private:
+
+	// Loop of thread
+	void Run();
+
+	// Members
+	SampleRing& mrRing;
+	RingPolicy mPolicy;
+	Watchdog* mpWatchdog;
+	std::shared_ptr<EEGChain> mspChain; // accessed atomically
+	std::atomic<bool> mRunning{ true };
+	std::atomic<unsigned long long> mPublishedBlockCount{ 0 };
+	std::thread mThread;
+};
+
+#endif // EEG_PUBLISHER_H_
@@ -0,0 +1,214 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "EmotivLSL.h"
+#include "Acquisition.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+// State behind handle. Acquisition is created on start from the configuration of the moment
+struct emotivlsl_acquisition
+{
+	Config config;
+	std::unique_ptr<Acquisition> upAcquisition;
+	emotivlsl_sample_callback callbacks[ACQUISITION_STREAM_COUNT] = {};
+	void* userData[ACQUISITION_STREAM_COUNT] = {};
+	std::string lastError;
+};
+
+// Whether acquisition of handle is running
+static bool IsRunning(emotivlsl_handle handle)
+{
+	return handle->upAcquisition && handle->upAcquisition->IsRunning();
+}
+
+emotivlsl_handle emotivlsl_create(void)
+{
+	try
+	{
+		return new emotivlsl_acquisition();
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void emotivlsl_destroy(emotivlsl_handle handle)
+{
+	delete handle;
+}
+
+int emotivlsl_load_config(emotivlsl_handle handle, const char* filepath)
+{
+	if (!handle || !filepath)
+	{
+		return EMOTIVLSL_INVALID_ARGUMENT;
+	}
+	if (!handle->config.Load(filepath))
+	{
+		handle->lastError = std::string("Configuration could not be loaded from ") + filepath;
+		return EMOTIVLSL_ERROR;
+	}
+	return EMOTIVLSL_OK;
+}
+
+int emotivlsl_set_config(emotivlsl_handle handle, const char* key, const char* value)
+{
+	if (!handle || !key || !value)
+	{
+		return EMOTIVLSL_INVALID_ARGUMENT;
+	}
+	handle->config.Set(key, value);
+	return EMOTIVLSL_OK;
+}
+
+int emotivlsl_set_sample_callback(emotivlsl_handle handle, int stream, emotivlsl_sample_callback callback, void* user_data)
+{
+	if (!handle || stream < 0 || stream >= ACQUISITION_STREAM_COUNT)
+	{
+		return EMOTIVLSL_INVALID_ARGUMENT;
+	}
+	if (IsRunning(handle))
+	{
+		return EMOTIVLSL_RUNNING;
+	}
+	handle->callbacks[stream] = callback;
+	handle->userData[stream] = user_data;
+	return EMOTIVLSL_OK;
+}
+
+int emotivlsl_start(emotivlsl_handle handle)
+{
+	if (!handle)
+	{
+		return EMOTIVLSL_INVALID_ARGUMENT;
+	}
+	if (IsRunning(handle))
+	{
+		return EMOTIVLSL_RUNNING;
+	}
+
+	// No exception may leave the interface
+	try
+	{
+		handle->upAcquisition.reset();
+		handle->upAcquisition = std::unique_ptr<Acquisition>(new Acquisition(handle->config));
+		for (int stream = 0; stream < ACQUISITION_STREAM_COUNT; stream++)
+		{
+			emotivlsl_sample_callback callback = handle->callbacks[stream];
+			void* pUserData = handle->userData[stream];
+			if (callback)
+			{
+				handle->upAcquisition->SetSampleCallback((AcquisitionStream)stream, [callback, pUserData](const SampleBlock& rBlock)
+				{
+					callback(rBlock.values.data(), rBlock.timestamps.data(), rBlock.SampleCount(), rBlock.channelCount, pUserData);
+				});
+			}
+		}
+		if (!handle->upAcquisition->Start())
+		{
+			handle->lastError = "Another acquisition is running in this process";
+			return EMOTIVLSL_RUNNING;
+		}
+	}
+	catch (const std::exception& e)
+	{
+		handle->lastError = e.what();
+		return EMOTIVLSL_ERROR;
+	}
+	catch (...)
+	{
+		handle->lastError = "Unknown exception when starting acquisition";
+		return EMOTIVLSL_ERROR;
+	}
+	return EMOTIVLSL_OK;
+}
+
+int emotivlsl_stop(emotivlsl_handle handle)
+{
+	if (!handle)
+	{
+		return EMOTIVLSL_INVALID_ARGUMENT;
+	}
+	if (handle->upAcquisition)
+	{
+		handle->upAcquisition->Stop();
+	}
+	return EMOTIVLSL_OK;
+}
+
+int emotivlsl_is_running(emotivlsl_handle handle)
+{
+	return handle && IsRunning(handle) ? 1 : 0;
+}
+
+int emotivlsl_get_stats(emotivlsl_handle handle, emotivlsl_stats* stats)
+{
+	if (!handle || !stats || stats->size == 0)
+	{
+		return EMOTIVLSL_INVALID_ARGUMENT;
+	}
+
+	// Fill complete structure, copy as much as caller knows of
+	emotivlsl_stats filled;
+	std::memset(&filled, 0, sizeof(filled));
+	filled.size = std::min((unsigned int)sizeof(filled), stats->size);
+	if (handle->upAcquisition)
+	{
+		AcquisitionStatistics statistics = handle->upAcquisition->GetStatistics();
+		filled.engine_connected = statistics.engineConnected ? 1 : 0;
+		filled.user_present = statistics.userPresent ? 1 : 0;
+		filled.effective_sample_rate = statistics.effectiveSampleRate;
+		filled.drift_ppm = statistics.drift;
+		filled.jitter = statistics.jitter;
+		filled.published_blocks = statistics.publishedBlockCount;
+		filled.dropped_blocks = statistics.droppedBlockCount;
+		filled.stalls = statistics.stallCount;
+		filled.resident_memory_mib = statistics.residentMemory;
+		filled.lost_blocks = statistics.lostBlockCount;
+	}
+	std::memcpy(stats, &filled, filled.size);
+	return EMOTIVLSL_OK;
+}
+
+const char* emotivlsl_get_last_error(emotivlsl_handle handle)
+{
+	if (!handle)
+	{
+		return "";
+	}
+
+	// Error of acquisition thread takes precedence
+	if (handle->upAcquisition)
+	{
+		std::string error = handle->upAcquisition->GetError();
+		if (!error.empty())
+		{
+			handle->lastError = error;
+		}
+	}
+	return handle->lastError.c_str();
+}
@@ -0,0 +1,119 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// C interface of the EmotivLSL library, for hosts embedding acquisition and
+// publishing in their own process. Samples can be received by callbacks right
+// where they are published, without going through LabStreamingLayer. Keys of
+// the configuration are those of EmotivLSL.cfg. Functions return
+// EMOTIVLSL_OK on success; after an error, a message is available from
+// emotivlsl_get_last_error.
+
+#ifndef EMOTIVLSL_H_
+#define EMOTIVLSL_H_
+
+#ifdef _WIN32
+#ifdef EMOTIVLSL_EXPORTS
+#define EMOTIVLSL_API __declspec(dllexport)
+#else
+#define EMOTIVLSL_API __declspec(dllimport)
+#endif
+#else
+#define EMOTIVLSL_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Return codes
+#define EMOTIVLSL_OK 0
+#define EMOTIVLSL_ERROR -1
+#define EMOTIVLSL_INVALID_ARGUMENT -2
+#define EMOTIVLSL_RUNNING -3 // not possible while acquisition is running
+
+// Streams whose samples can be received by callback
+#define EMOTIVLSL_STREAM_EEG 0 // called by a thread of its own with samples as acquired, before re-referencing
+#define EMOTIVLSL_STREAM_MOTION 1 // called by acquisition thread with samples as on EmotivLSL_Motion
+
+// Opaque handle of an acquisition
+typedef struct emotivlsl_acquisition* emotivlsl_handle;
+
+// Callback receiving interleaved values (sample after sample) and one timestamp per
+// sample in time of lsl_local_clock. Pointers are only valid during the call. EEG
+// points into the buffer acquisition has filled, callbacks slower than acquisition
+// lose blocks instead of holding it back
+typedef void (*emotivlsl_sample_callback)(const float* values, const double* timestamps, unsigned int sample_count, unsigned int channel_count, void* user_data);
+
+// Statistics of an acquisition. Caller sets size to sizeof(emotivlsl_stats), so fields
+// added in later versions are not written into older structures
+typedef struct emotivlsl_stats
+{
+	unsigned int size;
+	int engine_connected;
+	int user_present;
+	double effective_sample_rate; // Hz
+	double drift_ppm;
+	double jitter; // seconds
+	unsigned long long published_blocks;
+	unsigned long long dropped_blocks;
+	unsigned long long stalls;
+	double resident_memory_mib;
+	unsigned long long lost_blocks; // blocks the EEG callback was too slow for
+} emotivlsl_stats;
+
+// Create acquisition with default configuration. Returns null on failure
+EMOTIVLSL_API emotivlsl_handle emotivlsl_create(void);
+
+// Destroy acquisition, stopping it when running
+EMOTIVLSL_API void emotivlsl_destroy(emotivlsl_handle handle);
+
+// Read configuration from file of "key = value" lines. Values set before are overridden
+EMOTIVLSL_API int emotivlsl_load_config(emotivlsl_handle handle, const char* filepath);
+
+// Set single value of configuration
+EMOTIVLSL_API int emotivlsl_set_config(emotivlsl_handle handle, const char* key, const char* value);
+
+// Set callback for samples of stream, null to remove it. Not possible while running
+EMOTIVLSL_API int emotivlsl_set_sample_callback(emotivlsl_handle handle, int stream, emotivlsl_sample_callback callback, void* user_data);
+
+// Start acquisition on a thread of its own. Only one acquisition per process may run, starting
+// another one while it does returns EMOTIVLSL_RUNNING
+EMOTIVLSL_API int emotivlsl_start(emotivlsl_handle handle);
+
+// Stop acquisition, returning once its thread has ended
+EMOTIVLSL_API int emotivlsl_stop(emotivlsl_handle handle);
+
+// Whether acquisition is running. It ends on its own after an error or at the end of a replayed trace
+EMOTIVLSL_API int emotivlsl_is_running(emotivlsl_handle handle);
+
+// Fill statistics of current or last acquisition
+EMOTIVLSL_API int emotivlsl_get_stats(emotivlsl_handle handle, emotivlsl_stats* stats);
+
+// Message of last error, empty when there was none. Also set when the acquisition thread
+// ended on an exception, e.g. one thrown by a sample callback. Valid until the next call with handle
+EMOTIVLSL_API const char* emotivlsl_get_last_error(emotivlsl_handle handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMOTIVLSL_H_
@@ -0,0 +1,175 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "EngineBackend.h"
+
+// Including for Emotiv
+#include "IedkErrorCode.h"
+#include "IEmoStatePerformanceMetric.h"
+
+// Readers of model parameters per performance metric
+typedef void(*ModelParamsGetter)(EmoStateHandle, double*, double*, double*);
+static const ModelParamsGetter performanceMetricGetters[PERFORMANCE_METRIC_COUNT] =
+{
+	IS_PerformanceMetricGetStressModelParams,
+	IS_PerformanceMetricGetEngagementBoredomModelParams,
+	IS_PerformanceMetricGetRelaxationModelParams,
+	IS_PerformanceMetricGetInstantaneousExcitementModelParams,
+	IS_PerformanceMetricGetInterestModelParams
+};
+
+LiveEngine::LiveEngine()
+{
+	mEvent = IEE_EmoEngineEventCreate();
+	mState = IEE_EmoStateCreate();
+}
+
+LiveEngine::~LiveEngine()
+{
+	for (size_t i = 0; i < mStreams.size(); i++)
+	{
+		if (mStreamTypes[i] == ENGINE_STREAM_EEG)
+		{
+			IEE_DataFree(mStreams[i]);
+		}
+		else
+		{
+			IEE_MotionDataFree(mStreams[i]);
+		}
+	}
+	IEE_EmoStateFree(mState);
+	IEE_EmoEngineEventFree(mEvent);
+}
+
+int LiveEngine::Connect()
+{
+	return IEE_EngineConnect();
+}
+
+void LiveEngine::Disconnect()
+{
+	IEE_EngineDisconnect();
+}
+
+void LiveEngine::SetBufferSize(float seconds)
+{
+	IEE_DataSetBufferSizeInSec(seconds);
+	IEE_MotionDataSetBufferSizeInSec(seconds);
+}
+
+int LiveEngine::GetNextEvent(EngineEvent& rEvent)
+{
+	int error = IEE_EngineGetNextEvent(mEvent); // fills event
+	if (error != EDK_OK)
+	{
+		return error;
+	}
+	rEvent.type = IEE_EmoEngineEventGetType(mEvent);
+	rEvent.userID = 0;
+	IEE_EmoEngineEventGetUserId(mEvent, &rEvent.userID);
+	return error;
+}
+
+int LiveEngine::ReadEmoState(EmoStateSnapshot& rState)
+{
+	// EmoState of event is only valid until the next event
+	int error = IEE_EmoEngineEventGetEmoState(mEvent, mState); // fills state
+	if (error != EDK_OK)
+	{
+		return error;
+	}
+	rState.timeFromStart = IS_GetTimeFromStart(mState);
+	rState.blink = IS_FacialExpressionIsBlink(mState) != 0;
+	rState.winkLeft = IS_FacialExpressionIsLeftWink(mState) != 0;
+	rState.winkRight = IS_FacialExpressionIsRightWink(mState) != 0;
+	rState.upperFaceAction = IS_FacialExpressionGetUpperFaceAction(mState);
+	rState.upperFacePower = IS_FacialExpressionGetUpperFaceActionPower(mState);
+	rState.lowerFaceAction = IS_FacialExpressionGetLowerFaceAction(mState);
+	rState.lowerFacePower = IS_FacialExpressionGetLowerFaceActionPower(mState);
+	for (int metricIdx = 0; metricIdx < PERFORMANCE_METRIC_COUNT; metricIdx++)
+	{
+		double* pParams = rState.performanceMetrics[metricIdx];
+		performanceMetricGetters[metricIdx](mState, &pParams[0], &pParams[1], &pParams[2]);
+	}
+	return error;
+}
+
+void LiveEngine::EnableAcquisition(unsigned int userID)
+{
+	IEE_DataAcquisitionEnable(userID, true);
+}
+
+int LiveEngine::GetHeadsetSettings(unsigned int userID, unsigned int& rEpocMode, unsigned int& rEegRate)
+{
+	unsigned int eegResolution = 0;
+	unsigned int memsRate = 0;
+	unsigned int memsResolution = 0;
+	return IEE_GetHeadsetSettings(userID, &rEpocMode, &rEegRate, &eegResolution, &memsRate, &memsResolution);
+}
+
+int LiveEngine::GetMotionSampleRate(unsigned int userID, unsigned int& rSampleRate)
+{
+	return IEE_MotionDataGetSamplingRate(userID, &rSampleRate);
+}
+
+unsigned int LiveEngine::CreateStream(EngineStreamType type)
+{
+	mStreams.push_back(type == ENGINE_STREAM_EEG ? IEE_DataCreate() : IEE_MotionDataCreate());
+	mStreamTypes.push_back(type);
+	return (unsigned int)mStreams.size() - 1;
+}
+
+void LiveEngine::UpdateStream(unsigned int stream, unsigned int userID)
+{
+	if (mStreamTypes[stream] == ENGINE_STREAM_EEG)
+	{
+		IEE_DataUpdateHandle(userID, mStreams[stream]);
+	}
+	else
+	{
+		IEE_MotionDataUpdateHandle(userID, mStreams[stream]);
+	}
+}
+
+unsigned int LiveEngine::GetSampleCount(unsigned int stream)
+{
+	unsigned int sampleCount = 0;
+	if (mStreamTypes[stream] == ENGINE_STREAM_EEG)
+	{
+		IEE_DataGetNumberOfSample(mStreams[stream], &sampleCount);
+	}
+	else
+	{
+		IEE_MotionDataGetNumberOfSample(mStreams[stream], &sampleCount);
+	}
+	return sampleCount;
+}
+
+void LiveEngine::GetEEG(unsigned int stream, const IEE_DataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount)
+{
+	IEE_DataGetMultiChannels(mStreams[stream], const_cast<IEE_DataChannel_t*>(pChannels), channelCount, ppChannels, sampleCount);
+}
+
+void LiveEngine::GetMotion(unsigned int stream, const IEE_MotionDataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount)
+{
+	IEE_MotionDataGetMultiChannels(mStreams[stream], const_cast<IEE_MotionDataChannel_t*>(pChannels), channelCount, ppChannels, sampleCount);
+}
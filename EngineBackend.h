@@ -0,0 +1,156 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Backends of the EmoEngine. Acquisition talks to the EmoEngine only through
+// this interface, so the calls can be recorded into a trace (EngineTrace.h)
+// and the trace can be replayed later through the same code path, without
+// headset or EmoEngine. EmoStates are handed over as snapshots of the values
+// the streams need, as EmoState handles only exist inside the EmoEngine. They
+// are only read when asked for, so events nobody consumes cost no calls into
+// the EmoEngine.
+
+#ifndef ENGINE_BACKEND_H_
+#define ENGINE_BACKEND_H_
+
+#include "Iedk.h"
+#include "IEegData.h"
+#include "IEmoStateDLL.h"
+
+#include <cstddef>
+#include <vector>
+
+// Performance metrics of an EmoState
+enum PerformanceMetric
+{
+	PERFORMANCE_METRIC_STRESS,
+	PERFORMANCE_METRIC_ENGAGEMENT_BOREDOM,
+	PERFORMANCE_METRIC_RELAXATION,
+	PERFORMANCE_METRIC_EXCITEMENT,
+	PERFORMANCE_METRIC_INTEREST,
+	PERFORMANCE_METRIC_COUNT
+};
+
+// Values of an EmoState used by the facial expression and performance metrics streams
+struct EmoStateSnapshot
+{
+	float timeFromStart = 0.f; // seconds since start of EmoEngine
+	bool blink = false;
+	bool winkLeft = false;
+	bool winkRight = false;
+	IEE_FacialExpressionAlgo_t upperFaceAction = FE_NEUTRAL;
+	float upperFacePower = 0.f;
+	IEE_FacialExpressionAlgo_t lowerFaceAction = FE_NEUTRAL;
+	float lowerFacePower = 0.f;
+	double performanceMetrics[PERFORMANCE_METRIC_COUNT][3] = {}; // raw score, minimum and maximum of scale
+};
+
+// Event taken from the queue of the EmoEngine
+struct EngineEvent
+{
+	IEE_Event_t type = IEE_UnknownEvent;
+	unsigned int userID = 0;
+};
+
+// Kinds of data streams
+enum EngineStreamType
+{
+	ENGINE_STREAM_EEG,
+	ENGINE_STREAM_MOTION
+};
+
+class EngineBackend
+{
+public:
+
+	// Destructor
+	virtual ~EngineBackend() {}
+
+	// Connection to the EmoEngine, returning its error code
+	virtual int Connect() = 0;
+	virtual void Disconnect() = 0;
+
+	// Size of the buffers of EEG and motion data in the EmoEngine
+	virtual void SetBufferSize(float seconds) = 0;
+
+	// Take next event from queue, returns EDK_NO_EVENT when queue is empty
+	virtual int GetNextEvent(EngineEvent& rEvent) = 0;
+
+	// Read EmoState of event taken last, which must be IEE_EmoStateUpdated. Returns error code
+	virtual int ReadEmoState(EmoStateSnapshot& rState) = 0;
+
+	// Headset of user
+	virtual void EnableAcquisition(unsigned int userID) = 0;
+	virtual int GetHeadsetSettings(unsigned int userID, unsigned int& rEpocMode, unsigned int& rEegRate) = 0;
+	virtual int GetMotionSampleRate(unsigned int userID, unsigned int& rSampleRate) = 0;
+
+	// Create data stream, which lives as long as the backend. Returns its index
+	virtual unsigned int CreateStream(EngineStreamType type) = 0;
+
+	// Move samples buffered for user into stream, then ask for their count and fetch them
+	virtual void UpdateStream(unsigned int stream, unsigned int userID) = 0;
+	virtual unsigned int GetSampleCount(unsigned int stream) = 0;
+	virtual void GetEEG(unsigned int stream, const IEE_DataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount) = 0;
+	virtual void GetMotion(unsigned int stream, const IEE_MotionDataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount) = 0;
+
+	// Whether calls take as long as with the EmoEngine. Otherwise acquisition does not wait between iterations
+	virtual bool IsPaced() const { return true; }
+
+	// Whether nothing is left to acquire, e.g. at the end of a replayed trace
+	virtual bool IsFinished() const { return false; }
+};
+
+// Backend calling the EmoEngine
+class LiveEngine : public EngineBackend
+{
+public:
+
+	// Constructor
+	LiveEngine();
+
+	// Destructor, frees handles
+	virtual ~LiveEngine();
+
+	// Implementation of interface
+	virtual int Connect();
+	virtual void Disconnect();
+	virtual void SetBufferSize(float seconds);
+	virtual int GetNextEvent(EngineEvent& rEvent);
+	virtual int ReadEmoState(EmoStateSnapshot& rState);
+	virtual void EnableAcquisition(unsigned int userID);
+	virtual int GetHeadsetSettings(unsigned int userID, unsigned int& rEpocMode, unsigned int& rEegRate);
+	virtual int GetMotionSampleRate(unsigned int userID, unsigned int& rSampleRate);
+	virtual unsigned int CreateStream(EngineStreamType type);
+	virtual void UpdateStream(unsigned int stream, unsigned int userID);
+	virtual unsigned int GetSampleCount(unsigned int stream);
+	virtual void GetEEG(unsigned int stream, const IEE_DataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount);
+	virtual void GetMotion(unsigned int stream, const IEE_MotionDataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount);
+
+private:
+
+	// Members
+	EmoEngineEventHandle mEvent;
+	EmoStateHandle mState;
+	std::vector<DataHandle> mStreams;
+	std::vector<EngineStreamType> mStreamTypes;
+};
+
+#endif // ENGINE_BACKEND_H_
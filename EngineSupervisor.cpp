@@ -0,0 +1,161 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "EngineSupervisor.h"
+#include "MemoryBounds.h"
+
+// Including for Emotiv
+#include "IedkErrorCode.h"
+
+#include <algorithm>
+#include <iostream>
+
+// Defines
+const double initialBackoff = 0.5; // seconds until first reconnection attempt
+const double maximalBackoff = 8.0; // upper bound of seconds between reconnection attempts
+
+// Channel labels of connection stream
+const std::vector<std::string> connectionLabels =
+{
+	"ENGINE_CONNECTED",
+	"USER_PRESENT",
+	"LAST_DOWNTIME", // seconds the last dropout of engine or headset lasted, zero while it lasts
+	"RECONNECT_ATTEMPTS",
+	"DROPOUT_COUNT",
+	"TOTAL_DOWNTIME"
+};
+
+EngineSupervisor::EngineSupervisor(EngineBackend& rEngine, const Config& rConfig) : mrEngine(rEngine)
+{
+	// Start filling information about stream
+	lsl::stream_info streamInfo("EmotivLSL_Connection", "Markers", (int)connectionLabels.size(), lsl::IRREGULAR_RATE, lsl::cf_double64, "source_id");
+	streamInfo.desc().append_child_value("manufacturer", "Emotiv");
+
+	// Save information about channels
+	lsl::xml_element channels = streamInfo.desc().append_child("channels");
+	for (const auto& rLabel : connectionLabels)
+	{
+		channels.append_child("channel")
+			.append_child_value("label", rLabel);
+	}
+
+	// Create stream outlet with information header
+	mupOutlet = CreateOutlet(streamInfo, rConfig);
+}
+
+void EngineSupervisor::ReportConnectResult(bool success, double now)
+{
+	if (success)
+	{
+		// Measure how long engine was gone
+		double downtime = 0.0;
+		if (mEngineLostTime >= 0.0)
+		{
+			downtime = now - mEngineLostTime;
+			mTotalDowntime += downtime;
+			std::cout << "EmoEngine reconnected after " << downtime << " s and " << mAttempts << " attempts" << std::endl;
+		}
+		mConnected = true;
+		mEngineLostTime = -1.0;
+		mBackoff = 0.0;
+		mAttempts = 0;
+		if (mConnectedCallback)
+		{
+			mConnectedCallback();
+		}
+		Publish(now, downtime);
+	}
+	else
+	{
+		// Schedule next attempt
+		if (mEngineLostTime < 0.0)
+		{
+			mEngineLostTime = now;
+		}
+		mConnected = false;
+		mAttempts++;
+		mBackoff = (mBackoff <= 0.0) ? initialBackoff : std::min(mBackoff * 2.0, maximalBackoff);
+		mNextAttempt = now + mBackoff;
+		std::cout << "Connection to EmoEngine failed, retrying in " << mBackoff << " s" << std::endl;
+		Publish(now, 0.0);
+	}
+}
+
+bool EngineSupervisor::Update(double now)
+{
+	if (!mConnected && now >= mNextAttempt)
+	{
+		ReportConnectResult(mrEngine.Connect() == EDK_OK, now);
+	}
+	return mConnected;
+}
+
+void EngineSupervisor::ReportEngineFailure(int errorCode, double now)
+{
+	std::cout << "EmoEngine reported error " << errorCode << ", reconnecting" << std::endl;
+	mrEngine.Disconnect();
+	mConnected = false;
+	mUserPresent = false;
+	mDropoutCount++;
+	mEngineLostTime = now;
+	mBackoff = 0.0;
+	mAttempts = 0;
+	mNextAttempt = now;
+	Publish(now, 0.0);
+}
+
+void EngineSupervisor::ReportUserAdded(double now)
+{
+	// Measure how long headset was gone
+	double downtime = 0.0;
+	if (mUserLostTime >= 0.0)
+	{
+		downtime = now - mUserLostTime;
+		mTotalDowntime += downtime;
+		std::cout << "Headset recovered after " << downtime << " s" << std::endl;
+	}
+	mUserPresent = true;
+	mUserLostTime = -1.0;
+	Publish(now, downtime);
+}
+
+void EngineSupervisor::ReportUserRemoved(double now)
+{
+	mUserPresent = false;
+	mUserLostTime = now;
+	mDropoutCount++;
+	Publish(now, 0.0);
+}
+
+void EngineSupervisor::Publish(double now, double lastDowntime)
+{
+	std::vector<double> values =
+	{
+		mConnected ? 1.0 : 0.0,
+		mUserPresent ? 1.0 : 0.0,
+		lastDowntime,
+		(double)mAttempts,
+		(double)mDropoutCount,
+		mTotalDowntime
+	};
+	mupOutlet->push_sample(values, now);
+}
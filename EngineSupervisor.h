@@ -0,0 +1,88 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Supervision of the connection to the EmoEngine and of the headset. Outlets
+// stay alive while the headset is removed or the EmoEngine is reconnected, so
+// consumers do not have to resolve the streams again. Reconnection attempts
+// back off exponentially. Every change of state is published on the
+// EmotivLSL_Connection stream, including how long a dropout lasted.
+
+#ifndef ENGINE_SUPERVISOR_H_
+#define ENGINE_SUPERVISOR_H_
+
+#include "lsl_cpp.h"
+
+#include "Config.h"
+#include "EngineBackend.h"
+
+#include <functional>
+#include <memory>
+
+class EngineSupervisor
+{
+public:
+
+	// Constructor with backend to reconnect, creates the outlet for connection metrics as configured
+	EngineSupervisor(EngineBackend& rEngine, const Config& rConfig);
+
+	// Callback executed after each successful (re)connection, e.g. to configure buffers again
+	void SetConnectedCallback(std::function<void()> callback) { mConnectedCallback = callback; }
+
+	// Tell about result of a connection attempt made elsewhere, e.g. the first one at startup
+	void ReportConnectResult(bool success, double now);
+
+	// Reconnect if necessary and due. Returns whether EmoEngine is connected
+	bool Update(double now);
+
+	// Tell that the EmoEngine reported an error other than an empty event queue
+	void ReportEngineFailure(int errorCode, double now);
+
+	// Tell about headset being added or removed
+	void ReportUserAdded(double now);
+	void ReportUserRemoved(double now);
+
+	// Getters
+	bool IsConnected() const { return mConnected; }
+	unsigned int GetDropoutCount() const { return mDropoutCount; }
+	double GetTotalDowntime() const { return mTotalDowntime; }
+
+private:
+
+	// Push current state to the outlet
+	void Publish(double now, double lastDowntime);
+
+	// Members
+	EngineBackend& mrEngine;
+	std::unique_ptr<lsl::stream_outlet> mupOutlet;
+	std::function<void()> mConnectedCallback;
+	bool mConnected = false;
+	bool mUserPresent = false;
+	double mNextAttempt = 0.0;
+	double mBackoff = 0.0;
+	unsigned int mAttempts = 0; // failed attempts since connection was lost
+	double mEngineLostTime = -1.0; // time when connection to engine got lost, negative when not lost
+	double mUserLostTime = -1.0; // time when headset got removed, negative when present or never seen
+	unsigned int mDropoutCount = 0;
+	double mTotalDowntime = 0.0;
+};
+
+#endif // ENGINE_SUPERVISOR_H_
@@ -0,0 +1,501 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "EngineTrace.h"
+#include "IedkErrorCode.h"
+#include "lsl_cpp.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+// Defines
+const char traceMagic[8] = { 'E', 'M', 'L', 'S', 'L', 'T', 'R', 'C' };
+const uint32_t traceVersion = 2; // EmoStates are recorded apart from their events
+
+// Channels stored with each stream update. Device profiles use a subset of the EEG channels
+static const IEE_DataChannel_t tracedEEGChannels[] =
+{
+	IED_AF3, IED_F7, IED_F3, IED_FC5, IED_T7, IED_P7, IED_O1,
+	IED_O2, IED_P8, IED_T8, IED_FC6, IED_F4, IED_F8, IED_AF4
+};
+static const IEE_MotionDataChannel_t tracedMotionChannels[] =
+{
+	IMD_GYROX, IMD_GYROY, IMD_GYROZ,
+	IMD_ACCX, IMD_ACCY, IMD_ACCZ,
+	IMD_MAGX, IMD_MAGY, IMD_MAGZ
+};
+const unsigned int tracedEEGChannelCount = sizeof(tracedEEGChannels) / sizeof(IEE_DataChannel_t);
+const unsigned int tracedMotionChannelCount = sizeof(tracedMotionChannels) / sizeof(IEE_MotionDataChannel_t);
+
+// Count of channels stored for kind of stream
+static unsigned int TracedChannelCount(EngineStreamType type)
+{
+	return type == ENGINE_STREAM_EEG ? tracedEEGChannelCount : tracedMotionChannelCount;
+}
+
+// Copy requested channels out of traced ones. Channels that are not traced are filled with NaN
+template<typename Channel>
+static void CopyChannels(const Channel* pTraced, unsigned int tracedCount, const float* pValues, unsigned int tracedSampleCount,
+	const Channel* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount)
+{
+	unsigned int copyCount = std::min(sampleCount, tracedSampleCount);
+	for (unsigned int channelIdx = 0; channelIdx < channelCount; channelIdx++)
+	{
+		const Channel* pFound = std::find(pTraced, pTraced + tracedCount, pChannels[channelIdx]);
+		if (pFound == pTraced + tracedCount)
+		{
+			std::fill(ppChannels[channelIdx], ppChannels[channelIdx] + sampleCount, std::numeric_limits<double>::quiet_NaN());
+			continue;
+		}
+		const float* pSource = pValues + (size_t)(pFound - pTraced) * tracedSampleCount;
+		std::copy(pSource, pSource + copyCount, ppChannels[channelIdx]);
+	}
+}
+
+// Sequential reading from trace in memory
+class TraceReader
+{
+public:
+
+	// Constructor
+	TraceReader(const std::vector<char>& rBuffer) : mrBuffer(rBuffer) {}
+
+	// Read value from raw bytes. Throws when trace ends before
+	template<typename T>
+	T Read()
+	{
+		if (mPosition + sizeof(T) > mrBuffer.size())
+		{
+			throw std::runtime_error("Trace is truncated");
+		}
+		T value;
+		std::memcpy(&value, &mrBuffer[mPosition], sizeof(T));
+		mPosition += sizeof(T);
+		return value;
+	}
+
+	// Whether end of trace is reached
+	bool AtEnd() const { return mPosition >= mrBuffer.size(); }
+
+private:
+
+	// Members
+	const std::vector<char>& mrBuffer;
+	size_t mPosition = 0;
+};
+
+// #################
+// ### RECORDING ###
+// #################
+
+TraceRecorder::TraceRecorder(std::unique_ptr<EngineBackend> upEngine, const std::string& rFilepath) :
+	mupEngine(std::move(upEngine)),
+	mFile(rFilepath, std::ios::binary)
+{
+	if (!mFile.is_open())
+	{
+		throw std::runtime_error("Trace could not be created at " + rFilepath);
+	}
+	mFile.write(traceMagic, sizeof(traceMagic));
+	Write<uint32_t>(traceVersion);
+	mLastRecordTime = lsl::local_clock();
+}
+
+int TraceRecorder::Connect()
+{
+	int result = mupEngine->Connect();
+	BeginRecord(TRACE_CONNECT);
+	Write<int32_t>(result);
+	return result;
+}
+
+void TraceRecorder::Disconnect()
+{
+	mupEngine->Disconnect();
+	mFile.flush();
+}
+
+void TraceRecorder::SetBufferSize(float seconds)
+{
+	mupEngine->SetBufferSize(seconds);
+}
+
+int TraceRecorder::GetNextEvent(EngineEvent& rEvent)
+{
+	int result = mupEngine->GetNextEvent(rEvent);
+	BeginRecord(TRACE_EVENT);
+	Write<int32_t>(result);
+	if (result != EDK_OK)
+	{
+		return result;
+	}
+	Write<int32_t>(rEvent.type);
+	Write<uint32_t>(rEvent.userID);
+	return result;
+}
+
+int TraceRecorder::ReadEmoState(EmoStateSnapshot& rState)
+{
+	// Only EmoStates acquisition reads are recorded, as only those are read at replay
+	int result = mupEngine->ReadEmoState(rState);
+	BeginRecord(TRACE_EMO_STATE);
+	Write<int32_t>(result);
+	if (result != EDK_OK)
+	{
+		return result;
+	}
+	Write<float>(rState.timeFromStart);
+	Write<uint8_t>((rState.blink ? 1 : 0) | (rState.winkLeft ? 2 : 0) | (rState.winkRight ? 4 : 0));
+	Write<int32_t>(rState.upperFaceAction);
+	Write<float>(rState.upperFacePower);
+	Write<int32_t>(rState.lowerFaceAction);
+	Write<float>(rState.lowerFacePower);
+	for (int metricIdx = 0; metricIdx < PERFORMANCE_METRIC_COUNT; metricIdx++)
+	{
+		for (int paramIdx = 0; paramIdx < 3; paramIdx++)
+		{
+			Write<double>(rState.performanceMetrics[metricIdx][paramIdx]);
+		}
+	}
+	return result;
+}
+
+void TraceRecorder::EnableAcquisition(unsigned int userID)
+{
+	mupEngine->EnableAcquisition(userID);
+}
+
+int TraceRecorder::GetHeadsetSettings(unsigned int userID, unsigned int& rEpocMode, unsigned int& rEegRate)
+{
+	int result = mupEngine->GetHeadsetSettings(userID, rEpocMode, rEegRate);
+	BeginRecord(TRACE_HEADSET_SETTINGS);
+	Write<int32_t>(result);
+	Write<uint32_t>(rEpocMode);
+	Write<uint32_t>(rEegRate);
+	return result;
+}
+
+int TraceRecorder::GetMotionSampleRate(unsigned int userID, unsigned int& rSampleRate)
+{
+	int result = mupEngine->GetMotionSampleRate(userID, rSampleRate);
+	BeginRecord(TRACE_MOTION_SAMPLE_RATE);
+	Write<int32_t>(result);
+	Write<uint32_t>(rSampleRate);
+	return result;
+}
+
+unsigned int TraceRecorder::CreateStream(EngineStreamType type)
+{
+	Stream stream;
+	stream.type = type;
+	mStreams.push_back(stream);
+	return mupEngine->CreateStream(type);
+}
+
+void TraceRecorder::UpdateStream(unsigned int stream, unsigned int userID)
+{
+	// Samples are fetched for all traced channels right away, so the trace does not depend on consumers
+	mupEngine->UpdateStream(stream, userID);
+	Stream& rStream = mStreams[stream];
+	unsigned int channelCount = TracedChannelCount(rStream.type);
+	rStream.sampleCount = mupEngine->GetSampleCount(stream);
+	mChannelData.resize((size_t)channelCount * rStream.sampleCount);
+	std::vector<double*> channelPointers(channelCount);
+	for (unsigned int i = 0; i < channelCount; i++)
+	{
+		channelPointers[i] = mChannelData.data() + (size_t)i * rStream.sampleCount;
+	}
+	if (rStream.sampleCount > 0)
+	{
+		if (rStream.type == ENGINE_STREAM_EEG)
+		{
+			mupEngine->GetEEG(stream, tracedEEGChannels, channelCount, channelPointers.data(), rStream.sampleCount);
+		}
+		else
+		{
+			mupEngine->GetMotion(stream, tracedMotionChannels, channelCount, channelPointers.data(), rStream.sampleCount);
+		}
+	}
+	rStream.values.assign(mChannelData.begin(), mChannelData.end());
+
+	// Record samples as published
+	BeginRecord(TRACE_STREAM_UPDATE);
+	Write<uint32_t>(stream);
+	Write<uint32_t>(rStream.sampleCount);
+	Write<uint8_t>((uint8_t)channelCount);
+	mFile.write(reinterpret_cast<const char*>(rStream.values.data()), sizeof(float) * rStream.values.size());
+}
+
+unsigned int TraceRecorder::GetSampleCount(unsigned int stream)
+{
+	return mStreams[stream].sampleCount;
+}
+
+void TraceRecorder::GetEEG(unsigned int stream, const IEE_DataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount)
+{
+	const Stream& rStream = mStreams[stream];
+	CopyChannels(tracedEEGChannels, tracedEEGChannelCount, rStream.values.data(), rStream.sampleCount, pChannels, channelCount, ppChannels, sampleCount);
+}
+
+void TraceRecorder::GetMotion(unsigned int stream, const IEE_MotionDataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount)
+{
+	const Stream& rStream = mStreams[stream];
+	CopyChannels(tracedMotionChannels, tracedMotionChannelCount, rStream.values.data(), rStream.sampleCount, pChannels, channelCount, ppChannels, sampleCount);
+}
+
+void TraceRecorder::BeginRecord(TraceRecordType type)
+{
+	// Time is accumulated from the written deltas, so rounding does not drift
+	uint32_t delta = (uint32_t)std::max(std::round((lsl::local_clock() - mLastRecordTime) * 1e6), 0.0);
+	mLastRecordTime += delta / 1e6;
+	Write<uint8_t>((uint8_t)type);
+	Write<uint32_t>(delta);
+}
+
+// ##############
+// ### REPLAY ###
+// ##############
+
+TraceReplayer::TraceReplayer(const std::string& rFilepath, bool originalTiming) : mOriginalTiming(originalTiming)
+{
+	// Read whole trace, so replay does not wait for the disk
+	std::ifstream file(rFilepath, std::ios::binary);
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Trace could not be opened at " + rFilepath);
+	}
+	std::vector<char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	TraceReader reader(buffer);
+	char magic[sizeof(traceMagic)];
+	for (char& rCharacter : magic) { rCharacter = reader.Read<char>(); }
+	if (std::memcmp(magic, traceMagic, sizeof(traceMagic)) != 0 || reader.Read<uint32_t>() != traceVersion)
+	{
+		throw std::runtime_error("No trace of this version at " + rFilepath);
+	}
+
+	// Sort records into queues
+	double time = 0.0;
+	while (!reader.AtEnd())
+	{
+		uint8_t type = reader.Read<uint8_t>();
+		time += reader.Read<uint32_t>() / 1e6;
+		Record record;
+		record.time = time;
+		switch (type)
+		{
+		case TRACE_CONNECT:
+			record.result = reader.Read<int32_t>();
+			break;
+		case TRACE_EVENT:
+			record.result = reader.Read<int32_t>();
+			if (record.result == EDK_OK)
+			{
+				record.event.type = (IEE_Event_t)reader.Read<int32_t>();
+				record.event.userID = reader.Read<uint32_t>();
+			}
+			break;
+		case TRACE_EMO_STATE:
+			record.result = reader.Read<int32_t>();
+			if (record.result == EDK_OK)
+			{
+				EmoStateSnapshot& rState = record.state;
+				rState.timeFromStart = reader.Read<float>();
+				uint8_t flags = reader.Read<uint8_t>();
+				rState.blink = (flags & 1) != 0;
+				rState.winkLeft = (flags & 2) != 0;
+				rState.winkRight = (flags & 4) != 0;
+				rState.upperFaceAction = (IEE_FacialExpressionAlgo_t)reader.Read<int32_t>();
+				rState.upperFacePower = reader.Read<float>();
+				rState.lowerFaceAction = (IEE_FacialExpressionAlgo_t)reader.Read<int32_t>();
+				rState.lowerFacePower = reader.Read<float>();
+				for (int metricIdx = 0; metricIdx < PERFORMANCE_METRIC_COUNT; metricIdx++)
+				{
+					for (int paramIdx = 0; paramIdx < 3; paramIdx++)
+					{
+						rState.performanceMetrics[metricIdx][paramIdx] = reader.Read<double>();
+					}
+				}
+			}
+			break;
+		case TRACE_HEADSET_SETTINGS:
+			record.result = reader.Read<int32_t>();
+			record.values[0] = reader.Read<uint32_t>();
+			record.values[1] = reader.Read<uint32_t>();
+			break;
+		case TRACE_MOTION_SAMPLE_RATE:
+			record.result = reader.Read<int32_t>();
+			record.values[0] = reader.Read<uint32_t>();
+			break;
+		case TRACE_STREAM_UPDATE:
+		{
+			record.stream = reader.Read<uint32_t>();
+			record.sampleCount = reader.Read<uint32_t>();
+			size_t valueCount = (size_t)reader.Read<uint8_t>() * record.sampleCount;
+			record.samples.resize(valueCount);
+			for (float& rValue : record.samples) { rValue = reader.Read<float>(); }
+			if (record.stream >= mUpdates.size())
+			{
+				mUpdates.resize(record.stream + 1);
+			}
+			mUpdates[record.stream].push_back(std::move(record));
+			continue;
+		}
+		default:
+			throw std::runtime_error("Trace holds unknown record at " + rFilepath);
+		}
+		mRecords[type].push_back(std::move(record));
+	}
+	mUpdateCursors.assign(mUpdates.size(), 0);
+	std::cout << "Trace loaded with " << mRecords[TRACE_EVENT].size() << " events over " << time << " s" << std::endl;
+	mStartTime = lsl::local_clock();
+}
+
+int TraceReplayer::Connect()
+{
+	const Record* pRecord = Take(mRecords[TRACE_CONNECT], mCursors[TRACE_CONNECT]);
+	return pRecord ? pRecord->result : EDK_OK;
+}
+
+int TraceReplayer::GetNextEvent(EngineEvent& rEvent)
+{
+	const Record* pRecord = Take(mRecords[TRACE_EVENT], mCursors[TRACE_EVENT]);
+	if (!pRecord)
+	{
+		return EDK_NO_EVENT;
+	}
+	if (pRecord->result == EDK_OK)
+	{
+		rEvent = pRecord->event;
+	}
+	return pRecord->result;
+}
+
+int TraceReplayer::ReadEmoState(EmoStateSnapshot& rState)
+{
+	// EmoState belongs to event taken before, so it is not waited for
+	if (mCursors[TRACE_EMO_STATE] >= mRecords[TRACE_EMO_STATE].size())
+	{
+		return EDK_UNKNOWN_ERROR;
+	}
+	const Record& rRecord = mRecords[TRACE_EMO_STATE][mCursors[TRACE_EMO_STATE]++];
+	if (rRecord.result == EDK_OK)
+	{
+		rState = rRecord.state;
+	}
+	return rRecord.result;
+}
+
+int TraceReplayer::GetHeadsetSettings(unsigned int, unsigned int& rEpocMode, unsigned int& rEegRate)
+{
+	const Record* pRecord = Take(mRecords[TRACE_HEADSET_SETTINGS], mCursors[TRACE_HEADSET_SETTINGS]);
+	if (!pRecord)
+	{
+		return EDK_UNKNOWN_ERROR;
+	}
+	rEpocMode = pRecord->values[0];
+	rEegRate = pRecord->values[1];
+	return pRecord->result;
+}
+
+int TraceReplayer::GetMotionSampleRate(unsigned int, unsigned int& rSampleRate)
+{
+	const Record* pRecord = Take(mRecords[TRACE_MOTION_SAMPLE_RATE], mCursors[TRACE_MOTION_SAMPLE_RATE]);
+	if (!pRecord)
+	{
+		return EDK_UNKNOWN_ERROR;
+	}
+	rSampleRate = pRecord->values[0];
+	return pRecord->result;
+}
+
+unsigned int TraceReplayer::CreateStream(EngineStreamType type)
+{
+	// Streams are created in the same order as when recording
+	mStreamTypes.push_back(type);
+	mCurrentUpdates.push_back(nullptr);
+	if (mUpdates.size() < mStreamTypes.size())
+	{
+		mUpdates.resize(mStreamTypes.size());
+		mUpdateCursors.resize(mStreamTypes.size(), 0);
+	}
+	return (unsigned int)mStreamTypes.size() - 1;
+}
+
+void TraceReplayer::UpdateStream(unsigned int stream, unsigned int)
+{
+	mCurrentUpdates[stream] = Take(mUpdates[stream], mUpdateCursors[stream]);
+}
+
+unsigned int TraceReplayer::GetSampleCount(unsigned int stream)
+{
+	return mCurrentUpdates[stream] ? mCurrentUpdates[stream]->sampleCount : 0;
+}
+
+void TraceReplayer::GetEEG(unsigned int stream, const IEE_DataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount)
+{
+	const Record* pRecord = mCurrentUpdates[stream];
+	if (pRecord && mStreamTypes[stream] == ENGINE_STREAM_EEG)
+	{
+		CopyChannels(tracedEEGChannels, tracedEEGChannelCount, pRecord->samples.data(), pRecord->sampleCount, pChannels, channelCount, ppChannels, sampleCount);
+	}
+}
+
+void TraceReplayer::GetMotion(unsigned int stream, const IEE_MotionDataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount)
+{
+	const Record* pRecord = mCurrentUpdates[stream];
+	if (pRecord && mStreamTypes[stream] == ENGINE_STREAM_MOTION)
+	{
+		CopyChannels(tracedMotionChannels, tracedMotionChannelCount, pRecord->samples.data(), pRecord->sampleCount, pChannels, channelCount, ppChannels, sampleCount);
+	}
+}
+
+bool TraceReplayer::IsFinished() const
+{
+	// Events are polled in every iteration, so they span the whole trace
+	return mCursors[TRACE_EVENT] >= mRecords[TRACE_EVENT].size();
+}
+
+const TraceReplayer::Record* TraceReplayer::Take(std::vector<Record>& rQueue, size_t& rCursor)
+{
+	if (rCursor >= rQueue.size())
+	{
+		return nullptr;
+	}
+	const Record* pRecord = &rQueue[rCursor++];
+	if (mOriginalTiming)
+	{
+		double wait = mStartTime + pRecord->time - lsl::local_clock();
+		if (wait > 0.0)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds((long long)(wait * 1e6)));
+		}
+	}
+	return pRecord;
+}
@@ -0,0 +1,162 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Record and replay of EmoEngine calls. The recorder wraps a backend and
+// writes the results of its calls with their payloads into a compact binary
+// trace: returned error codes, events, the values of EmoStates that were read,
+// headset settings and every update of a data stream with its samples. Each
+// record carries the time since the previous one in microseconds. Samples are
+// stored as 32 bit floats for all channels a stream may be asked for, which
+// loses nothing as samples are published as 32 bit floats anyway.
+//
+// The replayer reads a trace and answers the calls of acquisition from it,
+// either at the recorded times or as fast as possible, so traces taken in the
+// field can be used to benchmark acquisition and processing offline, also on
+// platforms without EmoEngine. Records are taken per kind of call in the order
+// they were recorded, so a replay with a different configuration, e.g. with
+// motion disabled, still sees all events and EEG samples.
+
+#ifndef ENGINE_TRACE_H_
+#define ENGINE_TRACE_H_
+
+#include "EngineBackend.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Kinds of records in a trace
+enum TraceRecordType
+{
+	TRACE_CONNECT,
+	TRACE_EVENT,
+	TRACE_HEADSET_SETTINGS,
+	TRACE_MOTION_SAMPLE_RATE,
+	TRACE_STREAM_UPDATE,
+	TRACE_EMO_STATE,
+	TRACE_RECORD_TYPE_COUNT
+};
+
+class TraceRecorder : public EngineBackend
+{
+public:
+
+	// Constructor with backend whose calls are recorded. Throws when trace file cannot be created
+	TraceRecorder(std::unique_ptr<EngineBackend> upEngine, const std::string& rFilepath);
+
+	// Implementation of interface, forwarding to the wrapped backend
+	virtual int Connect();
+	virtual void Disconnect();
+	virtual void SetBufferSize(float seconds);
+	virtual int GetNextEvent(EngineEvent& rEvent);
+	virtual int ReadEmoState(EmoStateSnapshot& rState);
+	virtual void EnableAcquisition(unsigned int userID);
+	virtual int GetHeadsetSettings(unsigned int userID, unsigned int& rEpocMode, unsigned int& rEegRate);
+	virtual int GetMotionSampleRate(unsigned int userID, unsigned int& rSampleRate);
+	virtual unsigned int CreateStream(EngineStreamType type);
+	virtual void UpdateStream(unsigned int stream, unsigned int userID);
+	virtual unsigned int GetSampleCount(unsigned int stream);
+	virtual void GetEEG(unsigned int stream, const IEE_DataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount);
+	virtual void GetMotion(unsigned int stream, const IEE_MotionDataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount);
+	virtual bool IsPaced() const { return mupEngine->IsPaced(); }
+	virtual bool IsFinished() const { return mupEngine->IsFinished(); }
+
+private:
+
+	// Write head of record, with time since previous record
+	void BeginRecord(TraceRecordType type);
+
+	// Write value as raw bytes
+	template<typename T>
+	void Write(T value) { mFile.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+	// Stream as fetched with its last update, all traced channels
+	struct Stream
+	{
+		EngineStreamType type;
+		unsigned int sampleCount = 0;
+		std::vector<float> values; // channel after channel
+	};
+
+	// Members
+	std::unique_ptr<EngineBackend> mupEngine;
+	std::ofstream mFile;
+	double mLastRecordTime;
+	std::vector<Stream> mStreams;
+	std::vector<double> mChannelData; // reusable buffer for fetching
+};
+
+class TraceReplayer : public EngineBackend
+{
+public:
+
+	// Constructor, reads whole trace. Throws when file cannot be read or is no valid trace
+	TraceReplayer(const std::string& rFilepath, bool originalTiming);
+
+	// Implementation of interface, answering from the trace
+	virtual int Connect();
+	virtual void Disconnect() {}
+	virtual void SetBufferSize(float) {}
+	virtual int GetNextEvent(EngineEvent& rEvent);
+	virtual int ReadEmoState(EmoStateSnapshot& rState);
+	virtual void EnableAcquisition(unsigned int) {}
+	virtual int GetHeadsetSettings(unsigned int userID, unsigned int& rEpocMode, unsigned int& rEegRate);
+	virtual int GetMotionSampleRate(unsigned int userID, unsigned int& rSampleRate);
+	virtual unsigned int CreateStream(EngineStreamType type);
+	virtual void UpdateStream(unsigned int stream, unsigned int userID);
+	virtual unsigned int GetSampleCount(unsigned int stream);
+	virtual void GetEEG(unsigned int stream, const IEE_DataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount);
+	virtual void GetMotion(unsigned int stream, const IEE_MotionDataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount);
+	virtual bool IsPaced() const { return mOriginalTiming; }
+	virtual bool IsFinished() const;
+
+private:
+
+	// Call as recorded
+	struct Record
+	{
+		double time = 0.0; // seconds since start of recording
+		int result = 0;
+		unsigned int values[2] = {}; // headset settings or motion sample rate
+		EngineEvent event;
+		EmoStateSnapshot state;
+		unsigned int stream = 0;
+		unsigned int sampleCount = 0;
+		std::vector<float> samples; // samples of stream update, channel after channel
+	};
+
+	// Take next record of queue, waiting for its time when replaying with original timing. Returns null when none is left
+	const Record* Take(std::vector<Record>& rQueue, size_t& rCursor);
+
+	// Members
+	bool mOriginalTiming;
+	double mStartTime;
+	std::vector<Record> mRecords[TRACE_RECORD_TYPE_COUNT]; // stream updates are kept per stream instead
+	size_t mCursors[TRACE_RECORD_TYPE_COUNT] = {};
+	std::vector<std::vector<Record> > mUpdates; // per stream
+	std::vector<size_t> mUpdateCursors;
+	std::vector<const Record*> mCurrentUpdates; // per stream, null before first update
+	std::vector<EngineStreamType> mStreamTypes;
+};
+
+#endif // ENGINE_TRACE_H_
@@ -0,0 +1,312 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "FeatureExtractor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+// Defines
+const unsigned int featureResyncWindows = 16; // windows between recomputations from scratch
+const double featurePowerFloor = 1e-12; // keeps logarithm of silent bands finite
+const double pi = 3.14159265358979323846;
+
+// Frequency without trailing zeros, e.g. 8 or 12.5
+static std::string FormatFrequency(double frequency)
+{
+	std::string text = std::to_string(frequency);
+	text.erase(text.find_last_not_of('0') + 1);
+	if (text.back() == '.')
+	{
+		text.pop_back();
+	}
+	return text;
+}
+
+std::vector<FrequencyBand> ParseFrequencyBands(const std::vector<std::string>& rBands)
+{
+	std::vector<FrequencyBand> bands;
+	for (const auto& rBand : rBands)
+	{
+		size_t separator = rBand.find('-');
+		FrequencyBand band;
+		band.low = separator == std::string::npos ? 0.0 : std::atof(rBand.substr(0, separator).c_str());
+		band.high = separator == std::string::npos ? 0.0 : std::atof(rBand.substr(separator + 1).c_str());
+		if (band.high <= band.low)
+		{
+			throw std::runtime_error("Malformed frequency band: " + rBand);
+		}
+		bands.push_back(band);
+	}
+	return bands;
+}
+
+FeatureExtractor::FeatureExtractor(unsigned int channelCount, double sampleRate, unsigned int windowLength, unsigned int hop, const std::vector<FrequencyBand>& rBands) :
+	mChannelCount(channelCount),
+	mWindowLength(std::max(windowLength, 2u)),
+	mHop(std::max(hop, 1u)),
+	mBands(rBands)
+{
+	// Bins of bands, skipping DC
+	double binWidth = sampleRate / mWindowLength;
+	for (const auto& rBand : mBands)
+	{
+		std::vector<unsigned int> bandBins;
+		for (unsigned int bin = 1; bin <= mWindowLength / 2; bin++)
+		{
+			double frequency = bin * binWidth;
+			if (frequency >= rBand.low && frequency < rBand.high)
+			{
+				bandBins.push_back((unsigned int)mBins.size());
+				mBins.push_back(bin);
+			}
+		}
+		if (bandBins.empty())
+		{
+			throw std::runtime_error("Frequency band " + FormatFrequency(rBand.low) + "-" + FormatFrequency(rBand.high)
+				+ " Hz contains no DFT bin, use a longer window");
+		}
+		mBandBins.push_back(bandBins);
+	}
+	for (unsigned int bin : mBins)
+	{
+		mTwiddles.push_back(std::polar(1.0, 2.0 * pi * bin / mWindowLength));
+	}
+
+	// Band powers and Hjorth parameters per channel, covariance of channel pairs
+	mFeatureCount = mChannelCount * ((unsigned int)mBands.size() + 3) + mChannelCount * (mChannelCount + 1) / 2;
+	Reset();
+}
+
+void FeatureExtractor::Process(const SampleBlock& rInput, SampleBlock& rOutput)
+{
+	rOutput.Resize(mFeatureCount, 0);
+	unsigned int sampleCount = rInput.SampleCount();
+	for (unsigned int sampleIdx = 0; sampleIdx < sampleCount; sampleIdx++)
+	{
+		Add(&rInput.values[(size_t)sampleIdx * mChannelCount]);
+
+		// Feature vector every hop once the window is full
+		if (mAddedCount >= mWindowLength && mSinceHop >= mHop)
+		{
+			mSinceHop = 0;
+			unsigned int featureIdx = rOutput.SampleCount();
+			rOutput.Resize(mFeatureCount, featureIdx + 1);
+			rOutput.timestamps[featureIdx] = rInput.timestamps[sampleIdx];
+			Extract(&rOutput.values[(size_t)featureIdx * mFeatureCount]);
+		}
+	}
+}
+
+void FeatureExtractor::Reset()
+{
+	size_t windowSize = (size_t)mWindowLength * mChannelCount;
+	mSpectrum.assign((size_t)mChannelCount * mBins.size(), std::complex<double>(0.0, 0.0));
+	mValues.assign(windowSize, 0.0);
+	mFirstDifferences.assign(windowSize, 0.0);
+	mSecondDifferences.assign(windowSize, 0.0);
+	mPrevious.assign(mChannelCount, 0.0);
+	mPreviousDifference.assign(mChannelCount, 0.0);
+	mSum.assign(mChannelCount, 0.0);
+	mSumSquares.assign(mChannelCount, 0.0);
+	mSumFirstDifferences.assign(mChannelCount, 0.0);
+	mSumSquaredFirstDifferences.assign(mChannelCount, 0.0);
+	mSumSecondDifferences.assign(mChannelCount, 0.0);
+	mSumSquaredSecondDifferences.assign(mChannelCount, 0.0);
+	mSumProducts.assign((size_t)mChannelCount * (mChannelCount + 1) / 2, 0.0);
+	mPosition = 0;
+	mAddedCount = 0;
+	mSinceHop = 0;
+	mSinceResync = 0;
+}
+
+std::vector<std::string> FeatureExtractor::GetLabels(const std::vector<std::string>& rChannelLabels) const
+{
+	std::vector<std::string> labels;
+	for (unsigned int channelIdx = 0; channelIdx < mChannelCount; channelIdx++)
+	{
+		for (const auto& rBand : mBands)
+		{
+			labels.push_back(rChannelLabels[channelIdx] + "_" + FormatFrequency(rBand.low) + "-" + FormatFrequency(rBand.high) + "HZ_LOGPOWER");
+		}
+		labels.push_back(rChannelLabels[channelIdx] + "_HJORTH_ACTIVITY");
+		labels.push_back(rChannelLabels[channelIdx] + "_HJORTH_MOBILITY");
+		labels.push_back(rChannelLabels[channelIdx] + "_HJORTH_COMPLEXITY");
+	}
+	for (unsigned int i = 0; i < mChannelCount; i++)
+	{
+		for (unsigned int j = i; j < mChannelCount; j++)
+		{
+			labels.push_back("COV_" + rChannelLabels[i] + "_" + rChannelLabels[j]);
+		}
+	}
+	return labels;
+}
+
+void FeatureExtractor::Add(const float* pSample)
+{
+	// Slot of oldest sample takes the newest one
+	size_t slot = (size_t)mPosition * mChannelCount;
+	double* pValues = &mValues[slot];
+	double* pFirstDifferences = &mFirstDifferences[slot];
+	double* pSecondDifferences = &mSecondDifferences[slot];
+	unsigned int binCount = (unsigned int)mBins.size();
+	for (unsigned int channelIdx = 0; channelIdx < mChannelCount; channelIdx++)
+	{
+		// Differences, zero for the first samples after reset
+		double value = pSample[channelIdx];
+		double firstDifference = mAddedCount > 0 ? value - mPrevious[channelIdx] : 0.0;
+		double secondDifference = mAddedCount > 1 ? firstDifference - mPreviousDifference[channelIdx] : 0.0;
+		mPrevious[channelIdx] = value;
+		mPreviousDifference[channelIdx] = firstDifference;
+
+		// Sliding DFT, the leaving sample is zero while the window fills
+		double change = value - pValues[channelIdx];
+		std::complex<double>* pSpectrum = &mSpectrum[(size_t)channelIdx * binCount];
+		for (unsigned int binIdx = 0; binIdx < binCount; binIdx++)
+		{
+			pSpectrum[binIdx] = (pSpectrum[binIdx] + change) * mTwiddles[binIdx];
+		}
+
+		// Sums for Hjorth parameters
+		mSum[channelIdx] += change;
+		mSumSquares[channelIdx] += value * value - pValues[channelIdx] * pValues[channelIdx];
+		mSumFirstDifferences[channelIdx] += firstDifference - pFirstDifferences[channelIdx];
+		mSumSquaredFirstDifferences[channelIdx] += firstDifference * firstDifference - pFirstDifferences[channelIdx] * pFirstDifferences[channelIdx];
+		mSumSecondDifferences[channelIdx] += secondDifference - pSecondDifferences[channelIdx];
+		mSumSquaredSecondDifferences[channelIdx] += secondDifference * secondDifference - pSecondDifferences[channelIdx] * pSecondDifferences[channelIdx];
+		pFirstDifferences[channelIdx] = firstDifference;
+		pSecondDifferences[channelIdx] = secondDifference;
+	}
+
+	// Sums of channel products, before the old values are overwritten
+	size_t pairIdx = 0;
+	for (unsigned int i = 0; i < mChannelCount; i++)
+	{
+		double newI = pSample[i];
+		double oldI = pValues[i];
+		for (unsigned int j = i; j < mChannelCount; j++)
+		{
+			mSumProducts[pairIdx++] += newI * pSample[j] - oldI * pValues[j];
+		}
+	}
+	for (unsigned int channelIdx = 0; channelIdx < mChannelCount; channelIdx++)
+	{
+		pValues[channelIdx] = pSample[channelIdx];
+	}
+
+	// Advance
+	mPosition = (mPosition + 1) % mWindowLength;
+	mAddedCount++;
+	mSinceHop++;
+	if (++mSinceResync >= featureResyncWindows * mWindowLength)
+	{
+		Resync();
+	}
+}
+
+void FeatureExtractor::Resync()
+{
+	mSinceResync = 0;
+	unsigned int binCount = (unsigned int)mBins.size();
+	std::fill(mSpectrum.begin(), mSpectrum.end(), std::complex<double>(0.0, 0.0));
+	std::fill(mSum.begin(), mSum.end(), 0.0);
+	std::fill(mSumSquares.begin(), mSumSquares.end(), 0.0);
+	std::fill(mSumFirstDifferences.begin(), mSumFirstDifferences.end(), 0.0);
+	std::fill(mSumSquaredFirstDifferences.begin(), mSumSquaredFirstDifferences.end(), 0.0);
+	std::fill(mSumSecondDifferences.begin(), mSumSecondDifferences.end(), 0.0);
+	std::fill(mSumSquaredSecondDifferences.begin(), mSumSquaredSecondDifferences.end(), 0.0);
+	std::fill(mSumProducts.begin(), mSumProducts.end(), 0.0);
+
+	// Go over window from oldest to newest sample, the newest one is at offset zero of the DFT phase
+	for (unsigned int age = 0; age < mWindowLength; age++)
+	{
+		size_t slot = (size_t)((mPosition + age) % mWindowLength) * mChannelCount;
+		unsigned int exponent = mWindowLength - 1 - age;
+		size_t pairIdx = 0;
+		for (unsigned int i = 0; i < mChannelCount; i++)
+		{
+			double value = mValues[slot + i];
+			for (unsigned int binIdx = 0; binIdx < binCount; binIdx++)
+			{
+				mSpectrum[(size_t)i * binCount + binIdx] += value * std::polar(1.0, 2.0 * pi * mBins[binIdx] * (exponent + 1) / mWindowLength);
+			}
+			mSum[i] += value;
+			mSumSquares[i] += value * value;
+			mSumFirstDifferences[i] += mFirstDifferences[slot + i];
+			mSumSquaredFirstDifferences[i] += mFirstDifferences[slot + i] * mFirstDifferences[slot + i];
+			mSumSecondDifferences[i] += mSecondDifferences[slot + i];
+			mSumSquaredSecondDifferences[i] += mSecondDifferences[slot + i] * mSecondDifferences[slot + i];
+			for (unsigned int j = i; j < mChannelCount; j++)
+			{
+				mSumProducts[pairIdx++] += value * mValues[slot + j];
+			}
+		}
+	}
+}
+
+void FeatureExtractor::Extract(float* pFeatures) const
+{
+	double count = mWindowLength;
+	unsigned int binCount = (unsigned int)mBins.size();
+	size_t featureIdx = 0;
+	for (unsigned int channelIdx = 0; channelIdx < mChannelCount; channelIdx++)
+	{
+		// Power of band as mean square amplitude of its bins
+		const std::complex<double>* pSpectrum = &mSpectrum[(size_t)channelIdx * binCount];
+		for (const auto& rBandBins : mBandBins)
+		{
+			double power = 0.0;
+			for (unsigned int binIdx : rBandBins)
+			{
+				power += std::norm(pSpectrum[binIdx]);
+			}
+			power *= 2.0 / (count * count);
+			pFeatures[featureIdx++] = (float)std::log(power + featurePowerFloor);
+		}
+
+		// Hjorth parameters from variances of signal and its differences
+		double mean = mSum[channelIdx] / count;
+		double variance = std::max(mSumSquares[channelIdx] / count - mean * mean, 0.0);
+		double meanFirst = mSumFirstDifferences[channelIdx] / count;
+		double varianceFirst = std::max(mSumSquaredFirstDifferences[channelIdx] / count - meanFirst * meanFirst, 0.0);
+		double meanSecond = mSumSecondDifferences[channelIdx] / count;
+		double varianceSecond = std::max(mSumSquaredSecondDifferences[channelIdx] / count - meanSecond * meanSecond, 0.0);
+		double mobility = variance > 0.0 ? std::sqrt(varianceFirst / variance) : 0.0;
+		double mobilityFirst = varianceFirst > 0.0 ? std::sqrt(varianceSecond / varianceFirst) : 0.0;
+		pFeatures[featureIdx++] = (float)variance;
+		pFeatures[featureIdx++] = (float)mobility;
+		pFeatures[featureIdx++] = (float)(mobility > 0.0 ? mobilityFirst / mobility : 0.0);
+	}
+
+	// Covariance of channel pairs
+	size_t pairIdx = 0;
+	for (unsigned int i = 0; i < mChannelCount; i++)
+	{
+		for (unsigned int j = i; j < mChannelCount; j++)
+		{
+			pFeatures[featureIdx++] = (float)((mSumProducts[pairIdx++] - mSum[i] * mSum[j] / count) / (count - 1.0));
+		}
+	}
+}
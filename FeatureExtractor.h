@@ -0,0 +1,109 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Feature vectors for classifiers over a sliding window of EEG: log band power
+// per channel and band, Hjorth activity, mobility and complexity per channel,
+// and the upper triangle of the channel covariance. All of them are updated
+// sample by sample, adding the newest and removing the oldest sample of the
+// window, so the cost per hop does not depend on the window length. Band power
+// comes from a sliding DFT of the bins within the bands. Accumulated rounding
+// is removed by recomputing everything from the window now and then.
+
+#ifndef FEATURE_EXTRACTOR_H_
+#define FEATURE_EXTRACTOR_H_
+
+#include "SampleBlock.h"
+
+#include <complex>
+#include <string>
+#include <vector>
+
+// Frequency band in Hz, lower bound included, upper one excluded
+struct FrequencyBand
+{
+	double low;
+	double high;
+};
+
+// Parse bands like "8-13". Throws runtime error if malformed
+std::vector<FrequencyBand> ParseFrequencyBands(const std::vector<std::string>& rBands);
+
+class FeatureExtractor
+{
+public:
+
+	// Constructor with window length and hop in samples
+	FeatureExtractor(unsigned int channelCount, double sampleRate, unsigned int windowLength, unsigned int hop, const std::vector<FrequencyBand>& rBands);
+
+	// Add samples of input block. Output block is replaced by a feature vector for every hop
+	// completed within the block, stamped with the newest sample of its window
+	void Process(const SampleBlock& rInput, SampleBlock& rOutput);
+
+	// Forget all samples, e.g. after a gap in the input
+	void Reset();
+
+	// Count of features per vector
+	unsigned int GetFeatureCount() const { return mFeatureCount; }
+
+	// Labels of features, given labels of channels
+	std::vector<std::string> GetLabels(const std::vector<std::string>& rChannelLabels) const;
+
+private:
+
+	// Add one sample to the window, removing the oldest one when full
+	void Add(const float* pSample);
+
+	// Recompute sums and spectrum from window
+	void Resync();
+
+	// Write features of current window
+	void Extract(float* pFeatures) const;
+
+	// Members
+	unsigned int mChannelCount;
+	unsigned int mWindowLength;
+	unsigned int mHop;
+	unsigned int mFeatureCount;
+	std::vector<FrequencyBand> mBands;
+	std::vector<unsigned int> mBins; // DFT bins within any band
+	std::vector<std::vector<unsigned int> > mBandBins; // per band, indices into bins
+	std::vector<std::complex<double> > mTwiddles; // per bin
+	std::vector<std::complex<double> > mSpectrum; // per channel and bin
+	std::vector<double> mValues; // ring of samples, window length rows of channels
+	std::vector<double> mFirstDifferences; // ring of first differences
+	std::vector<double> mSecondDifferences; // ring of second differences
+	std::vector<double> mPrevious; // previous sample per channel
+	std::vector<double> mPreviousDifference; // previous first difference per channel
+	std::vector<double> mSum; // per channel sums over window
+	std::vector<double> mSumSquares;
+	std::vector<double> mSumFirstDifferences;
+	std::vector<double> mSumSquaredFirstDifferences;
+	std::vector<double> mSumSecondDifferences;
+	std::vector<double> mSumSquaredSecondDifferences;
+	std::vector<double> mSumProducts; // upper triangle of sums of channel products
+	unsigned int mPosition = 0; // position of oldest sample in ring
+	unsigned long long mAddedCount = 0; // samples added since reset
+	unsigned int mSinceHop = 0; // samples since last feature vector
+	unsigned int mSinceResync = 0; // samples since last resync
+};
+
+#endif // FEATURE_EXTRACTOR_H_
@@ -0,0 +1,323 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "Hyperscanning.h"
+#include "MemoryBounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+HyperscanAggregator::HyperscanAggregator(EngineBackend& rEngine, const DeviceDescriptor& rDevice, unsigned int slotCount, double maxLatency, unsigned int clockWindowSize, const Config& rConfig) :
+	mrEngine(rEngine),
+	mrDevice(rDevice),
+	mParticipants(slotCount, Participant(clockWindowSize)),
+	mMaxLatency(maxLatency)
+{
+	// Buffer has to hold the samples of a grid point waiting for the latest headset
+	mMaxBufferedSamples = (unsigned int)std::ceil(2.0 * mMaxLatency * mrDevice.sampleRate) + 1;
+
+	// Channels of all slots after each other, prefixed with participant
+	lsl::stream_info streamInfo("EmotivLSL_EEG_Hyperscanning", "EEG", mrDevice.channelCount * slotCount, mrDevice.sampleRate, lsl::cf_float32, "source_id");
+	streamInfo.desc().append_child_value("manufacturer", "Emotiv");
+	streamInfo.desc().append_child_value("model", mrDevice.name);
+	lsl::xml_element channels = streamInfo.desc().append_child("channels");
+	for (unsigned int slotIdx = 0; slotIdx < slotCount; slotIdx++)
+	{
+		for (const auto& rLabel : mrDevice.labels)
+		{
+			channels.append_child("channel")
+				.append_child_value("label", "P" + std::to_string(slotIdx + 1) + "_" + rLabel)
+				.append_child_value("unit", mrDevice.unit)
+				.append_child_value("type", "EEG");
+		}
+	}
+	streamInfo.desc().append_child("hyperscanning")
+		.append_child_value("participants", std::to_string(slotCount))
+		.append_child_value("max_latency", std::to_string(mMaxLatency));
+	mupOutlet = CreateOutlet(streamInfo, rConfig);
+}
+
+bool HyperscanAggregator::AddUser(unsigned int userID, const DeviceDescriptor& rDevice)
+{
+	if (rDevice.channelCount != mrDevice.channelCount || rDevice.sampleRate != mrDevice.sampleRate)
+	{
+		std::cout << "Hyperscanning ignores user " << userID << ", " << rDevice.name << " does not match " << mrDevice.name << std::endl;
+		return false;
+	}
+
+	// Already participating after reconnection
+	Participant* pFree = nullptr;
+	for (Participant& rParticipant : mParticipants)
+	{
+		if (rParticipant.active && rParticipant.userID == userID)
+		{
+			pFree = &rParticipant;
+			break;
+		}
+		if (!rParticipant.active && !pFree)
+		{
+			pFree = &rParticipant;
+		}
+	}
+	if (!pFree)
+	{
+		std::cout << "Hyperscanning has no free slot for user " << userID << std::endl;
+		return false;
+	}
+
+	// Start over with clock model and buffer
+	if (!pFree->hasStream)
+	{
+		pFree->stream = mrEngine.CreateStream(ENGINE_STREAM_EEG);
+		pFree->hasStream = true;
+	}
+	pFree->active = true;
+	pFree->userID = userID;
+	pFree->clock.Reset();
+	pFree->sampleIndex = 0.0;
+	Consume(*pFree, true);
+	mrEngine.EnableAcquisition(userID);
+	std::cout << "Hyperscanning participant " << (pFree - mParticipants.data()) + 1 << " is user " << userID << std::endl;
+	return true;
+}
+
+void HyperscanAggregator::RemoveUser(unsigned int userID)
+{
+	for (Participant& rParticipant : mParticipants)
+	{
+		if (rParticipant.active && rParticipant.userID == userID)
+		{
+			rParticipant.active = false;
+			Consume(rParticipant, true);
+		}
+	}
+}
+
+void HyperscanAggregator::RemoveAllUsers()
+{
+	for (Participant& rParticipant : mParticipants)
+	{
+		rParticipant.active = false;
+		Consume(rParticipant, true);
+	}
+}
+
+void HyperscanAggregator::Update(double now)
+{
+	// Without consumers, samples are discarded and the grid starts over later
+	if (!mGate.Update(*mupOutlet, now))
+	{
+		for (Participant& rParticipant : mParticipants)
+		{
+			if (rParticipant.active)
+			{
+				mrEngine.UpdateStream(rParticipant.stream, rParticipant.userID);
+				Consume(rParticipant, true);
+			}
+		}
+		mGridStarted = false;
+		return;
+	}
+
+	// Acquire all participants at once
+	double fetchTime = lsl::local_clock();
+	bool anyActive = false;
+	for (Participant& rParticipant : mParticipants)
+	{
+		if (rParticipant.active)
+		{
+			Acquire(rParticipant, fetchTime);
+			anyActive = true;
+		}
+	}
+
+	// Grid starts over when the next participant arrives
+	if (!anyActive)
+	{
+		mGridStarted = false;
+		return;
+	}
+
+	// Grid starts at the oldest sample available
+	if (!mGridStarted)
+	{
+		double oldest = std::numeric_limits<double>::max();
+		for (const Participant& rParticipant : mParticipants)
+		{
+			if (rParticipant.active && rParticipant.buffered.SampleCount() > 0)
+			{
+				oldest = std::min(oldest, rParticipant.buffered.timestamps.front());
+			}
+		}
+		if (oldest == std::numeric_limits<double>::max())
+		{
+			return;
+		}
+		mGridStart = oldest;
+		mGridIndex = 0;
+		mGridStarted = true;
+	}
+
+	// Emit grid points for which all participants have samples, or which are overdue
+	unsigned int channelCount = mrDevice.channelCount;
+	unsigned int slotCount = (unsigned int)mParticipants.size();
+	mOutput.Resize(channelCount * slotCount, 0);
+	while (true)
+	{
+		double time = mGridStart + (double)mGridIndex / mrDevice.sampleRate;
+		if (time > now)
+		{
+			break;
+		}
+		bool overdue = now >= time + mMaxLatency;
+		bool complete = true;
+		for (const Participant& rParticipant : mParticipants)
+		{
+			if (rParticipant.active && (rParticipant.buffered.SampleCount() == 0 || rParticipant.buffered.timestamps.back() < time))
+			{
+				complete = false;
+			}
+		}
+		if (!complete && !overdue)
+		{
+			break;
+		}
+
+		// Append sample, NaN for slots not covering the grid point
+		unsigned int sampleIdx = mOutput.SampleCount();
+		mOutput.Resize(channelCount * slotCount, sampleIdx + 1);
+		mOutput.timestamps[sampleIdx] = time;
+		for (unsigned int slotIdx = 0; slotIdx < slotCount; slotIdx++)
+		{
+			Participant& rParticipant = mParticipants[slotIdx];
+			float* pOutput = &mOutput.values[(size_t)sampleIdx * channelCount * slotCount + (size_t)slotIdx * channelCount];
+			if (!rParticipant.active || !Interpolate(rParticipant, time, pOutput))
+			{
+				std::fill(pOutput, pOutput + channelCount, std::numeric_limits<float>::quiet_NaN());
+				if (rParticipant.active)
+				{
+					mMissingSampleCount++;
+				}
+			}
+		}
+		mGridIndex++;
+	}
+
+	// Forget samples behind the grid
+	for (Participant& rParticipant : mParticipants)
+	{
+		Consume(rParticipant);
+	}
+
+	// Output aligned samples
+	if (mOutput.SampleCount() > 0)
+	{
+		mupOutlet->push_chunk_multiplexed(mOutput.values, mOutput.timestamps);
+	}
+}
+
+void HyperscanAggregator::Acquire(Participant& rParticipant, double fetchTime)
+{
+	// Fetch samples, stamped backwards from fetch time
+	mrEngine.UpdateStream(rParticipant.stream, rParticipant.userID);
+	unsigned int sampleCount = mrDevice.acquire(mrEngine, rParticipant.stream, rParticipant.channelData, rParticipant.fetched, fetchTime);
+	if (sampleCount == 0)
+	{
+		return;
+	}
+
+	// Restamp by clock model of headset, once it is settled
+	rParticipant.sampleIndex += sampleCount;
+	rParticipant.clock.Add(rParticipant.sampleIndex - 1.0, fetchTime);
+	if (rParticipant.clock.IsValid())
+	{
+		double firstIndex = rParticipant.sampleIndex - sampleCount;
+		double offset = rParticipant.clock.GetOffset();
+		double rate = rParticipant.clock.GetEffectiveRate();
+		for (unsigned int sampleIdx = 0; sampleIdx < sampleCount; sampleIdx++)
+		{
+			rParticipant.fetched.timestamps[sampleIdx] = offset + (firstIndex + sampleIdx) / rate;
+		}
+	}
+
+	// Append to buffer, dropping oldest samples beyond the bound
+	SampleBlock& rBuffered = rParticipant.buffered;
+	rBuffered.values.insert(rBuffered.values.end(), rParticipant.fetched.values.begin(), rParticipant.fetched.values.end());
+	rBuffered.timestamps.insert(rBuffered.timestamps.end(), rParticipant.fetched.timestamps.begin(), rParticipant.fetched.timestamps.end());
+	unsigned int bufferedCount = rBuffered.SampleCount();
+	if (bufferedCount > mMaxBufferedSamples)
+	{
+		unsigned int dropCount = bufferedCount - mMaxBufferedSamples;
+		rBuffered.values.erase(rBuffered.values.begin(), rBuffered.values.begin() + (size_t)dropCount * mrDevice.channelCount);
+		rBuffered.timestamps.erase(rBuffered.timestamps.begin(), rBuffered.timestamps.begin() + dropCount);
+		mDroppedSampleCount += dropCount;
+	}
+}
+
+bool HyperscanAggregator::Interpolate(Participant& rParticipant, double time, float* pOutput)
+{
+	// Advance to last sample at or before time
+	const SampleBlock& rBuffered = rParticipant.buffered;
+	unsigned int sampleCount = rBuffered.SampleCount();
+	while (rParticipant.cursor + 1 < sampleCount && rBuffered.timestamps[rParticipant.cursor + 1] <= time)
+	{
+		rParticipant.cursor++;
+	}
+
+	// Pair of samples around time is needed
+	unsigned int beforeIdx = rParticipant.cursor;
+	if (beforeIdx + 1 >= sampleCount || rBuffered.timestamps[beforeIdx] > time)
+	{
+		return false;
+	}
+	double before = rBuffered.timestamps[beforeIdx];
+	double after = rBuffered.timestamps[beforeIdx + 1];
+	float weight = after > before ? (float)((time - before) / (after - before)) : 0.f;
+
+	// Interpolate linearly between both samples
+	unsigned int channelCount = mrDevice.channelCount;
+	const float* pBefore = &rBuffered.values[(size_t)beforeIdx * channelCount];
+	const float* pAfter = pBefore + channelCount;
+	for (unsigned int channelIdx = 0; channelIdx < channelCount; channelIdx++)
+	{
+		pOutput[channelIdx] = pBefore[channelIdx] + weight * (pAfter[channelIdx] - pBefore[channelIdx]);
+	}
+	return true;
+}
+
+void HyperscanAggregator::Consume(Participant& rParticipant, bool clear)
+{
+	// Sample at cursor is kept, as it is needed for interpolating the next grid point
+	SampleBlock& rBuffered = rParticipant.buffered;
+	if (clear)
+	{
+		rBuffered.Resize(mrDevice.channelCount, 0);
+	}
+	else if (rParticipant.cursor > 0)
+	{
+		rBuffered.values.erase(rBuffered.values.begin(), rBuffered.values.begin() + (size_t)rParticipant.cursor * mrDevice.channelCount);
+		rBuffered.timestamps.erase(rBuffered.timestamps.begin(), rBuffered.timestamps.begin() + rParticipant.cursor);
+	}
+	rParticipant.cursor = 0;
+}
@@ -0,0 +1,114 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Aggregate EEG of several headsets on one stream for hyperscanning. Every
+// participant occupies a fixed slot of channels. Samples of each headset are
+// restamped by its own clock model and interpolated onto a common grid at the
+// nominal sample rate, so all channels of a sample belong to the same point
+// in time. A grid point waits for late headsets at most for the configured
+// latency, then their channels are filled with NaN, as are those of slots
+// without headset. Buffering per participant is bounded by that latency.
+
+#ifndef HYPERSCANNING_H_
+#define HYPERSCANNING_H_
+
+#include "lsl_cpp.h"
+
+#include "ClockEstimator.h"
+#include "Config.h"
+#include "ConsumerGate.h"
+#include "DeviceProfile.h"
+#include "SampleBlock.h"
+
+#include <memory>
+
+class HyperscanAggregator
+{
+public:
+
+	// Constructor with backend to acquire from, creates outlet with channels of device for every slot as configured
+	HyperscanAggregator(EngineBackend& rEngine, const DeviceDescriptor& rDevice, unsigned int slotCount, double maxLatency, unsigned int clockWindowSize, const Config& rConfig);
+
+	// Assign user to free slot. Returns false when there is none or device does not match
+	bool AddUser(unsigned int userID, const DeviceDescriptor& rDevice);
+
+	// Free slot of user
+	void RemoveUser(unsigned int userID);
+
+	// Free all slots, e.g. when connection to the EmoEngine broke
+	void RemoveAllUsers();
+
+	// Acquire samples of all participants and push grid points that are complete or overdue
+	void Update(double now);
+
+	// Count of participant samples dropped because buffer was full
+	unsigned long long GetDroppedSampleCount() const { return mDroppedSampleCount; }
+
+	// Count of participant channel groups filled with NaN while slot was in use
+	unsigned long long GetMissingSampleCount() const { return mMissingSampleCount; }
+
+private:
+
+	// State of one slot
+	struct Participant
+	{
+		Participant(unsigned int clockWindowSize) : clock(clockWindowSize) {}
+
+		bool active = false;
+		unsigned int userID = 0;
+		bool hasStream = false;
+		unsigned int stream = 0; // data stream of backend, kept when slot is freed
+		std::vector<double> channelData; // channel after channel, as filled by Emotiv
+		SampleBlock fetched; // samples of last fetch
+		SampleBlock buffered; // restamped samples not yet consumed by the grid
+		unsigned int cursor = 0; // buffered sample at or before the latest grid point
+		ClockEstimator clock;
+		double sampleIndex = 0.0; // count of samples since user has been added
+	};
+
+	// Acquire samples of participant and append them restamped to its buffer
+	void Acquire(Participant& rParticipant, double fetchTime);
+
+	// Interpolate samples of participant at time into output, advancing its cursor. Times
+	// must increase from call to call. Returns false if time is not covered by samples
+	bool Interpolate(Participant& rParticipant, double time, float* pOutput);
+
+	// Remove samples of participant before its cursor and clear its buffer if requested
+	void Consume(Participant& rParticipant, bool clear = false);
+
+	// Members
+	EngineBackend& mrEngine;
+	const DeviceDescriptor& mrDevice;
+	std::vector<Participant> mParticipants;
+	double mMaxLatency;
+	unsigned int mMaxBufferedSamples;
+	std::unique_ptr<lsl::stream_outlet> mupOutlet;
+	ConsumerGate mGate;
+	bool mGridStarted = false;
+	double mGridStart = 0.0;
+	unsigned long long mGridIndex = 0;
+	SampleBlock mOutput;
+	unsigned long long mDroppedSampleCount = 0;
+	unsigned long long mMissingSampleCount = 0;
+};
+
+#endif // HYPERSCANNING_H_
@@ -0,0 +1,77 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Statistics of latencies measured on one or more threads and read on another.
+// Values are collected until the reader takes them as an interval, e.g. once
+// per diagnostics sample.
+
+#ifndef LATENCY_MONITOR_H_
+#define LATENCY_MONITOR_H_
+
+#include <atomic>
+
+// Statistics of latencies in seconds over one interval
+struct LatencyInterval
+{
+	double mean = 0.0;
+	double max = 0.0;
+	unsigned long long count = 0;
+};
+
+class LatencyMonitor
+{
+public:
+
+	// Add latency in seconds. Fields are updated by compare and swap, so nothing read before the interval was taken is written back
+	void Add(double latency)
+	{
+		double sum = mSum.load();
+		while (!mSum.compare_exchange_weak(sum, sum + latency)) {}
+		mCount++;
+		double max = mMax.load();
+		while (latency > max && !mMax.compare_exchange_weak(max, latency)) {}
+	}
+
+	// Count of latencies since interval was taken last
+	unsigned long long GetCount() const { return mCount.load(); }
+
+	// Take statistics since last call and start over. Each field is swapped on its own, so a latency
+	// added meanwhile may count towards this interval with some fields and towards the next with others
+	LatencyInterval TakeInterval()
+	{
+		LatencyInterval interval;
+		interval.count = mCount.exchange(0);
+		double sum = mSum.exchange(0.0);
+		interval.max = mMax.exchange(0.0);
+		interval.mean = interval.count > 0 ? sum / interval.count : 0.0;
+		return interval;
+	}
+
+private:
+
+	// Members
+	std::atomic<double> mSum{ 0.0 };
+	std::atomic<double> mMax{ 0.0 };
+	std::atomic<unsigned long long> mCount{ 0 };
+};
+
+#endif // LATENCY_MONITOR_H_
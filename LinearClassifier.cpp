@@ -0,0 +1,154 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "LinearClassifier.h"
+#include "SIMD.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+LinearClassifier::LinearClassifier(const std::string& rFilepath, unsigned int featureCount) : mFeatureCount(featureCount)
+{
+	std::ifstream file(rFilepath);
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Could not open classifier model: " + rFilepath);
+	}
+
+	// Read keyword lines
+	std::vector<double> mean(mFeatureCount, 0.0);
+	std::vector<double> scale(mFeatureCount, 1.0);
+	std::vector<std::vector<double> > weights;
+	std::vector<double> bias;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream stream(line);
+		std::string keyword;
+		if (!(stream >> keyword) || keyword[0] == '#')
+		{
+			continue;
+		}
+		if (keyword == "classes")
+		{
+			std::string label;
+			while (stream >> label) { mClassLabels.push_back(label); }
+			continue;
+		}
+		std::vector<double> values;
+		double value = 0.0;
+		while (stream >> value) { values.push_back(value); }
+		if (keyword == "bias")
+		{
+			bias.insert(bias.end(), values.begin(), values.end());
+			continue;
+		}
+		if (values.size() != mFeatureCount)
+		{
+			throw std::runtime_error("Classifier model " + rFilepath + " has " + std::to_string(values.size()) + " values for " + keyword
+				+ ", expected one per feature (" + std::to_string(mFeatureCount) + ")");
+		}
+		if (keyword == "mean") { mean = values; }
+		else if (keyword == "scale") { scale = values; }
+		else if (keyword == "weights") { weights.push_back(values); }
+		else { throw std::runtime_error("Unknown keyword in classifier model " + rFilepath + ": " + keyword); }
+	}
+
+	// Check consistency
+	if (mClassLabels.size() < 2)
+	{
+		throw std::runtime_error("Classifier model " + rFilepath + " needs at least two classes");
+	}
+	mRowCount = (unsigned int)weights.size();
+	mBinary = mRowCount == 1 && mClassLabels.size() == 2;
+	if (mRowCount == 0 || (!mBinary && mRowCount != mClassLabels.size()) || bias.size() != mRowCount)
+	{
+		throw std::runtime_error("Classifier model " + rFilepath + " needs one weights and bias per class, or a single one for two classes");
+	}
+
+	// Fold normalization into weights and bias, so prediction is a plain dot product
+	mWeights.resize((size_t)mRowCount * mFeatureCount);
+	mBias.resize(mRowCount);
+	for (unsigned int rowIdx = 0; rowIdx < mRowCount; rowIdx++)
+	{
+		double rowBias = bias[rowIdx];
+		for (unsigned int featureIdx = 0; featureIdx < mFeatureCount; featureIdx++)
+		{
+			double weight = scale[featureIdx] != 0.0 ? weights[rowIdx][featureIdx] / scale[featureIdx] : 0.0;
+			mWeights[(size_t)rowIdx * mFeatureCount + featureIdx] = (float)weight;
+			rowBias -= weight * mean[featureIdx];
+		}
+		mBias[rowIdx] = (float)rowBias;
+	}
+	mScores.resize(mRowCount);
+}
+
+void LinearClassifier::Predict(const float* pFeatures, float* pProbabilities) const
+{
+	// Score of every row
+	float* pScores = mScores.data();
+	for (unsigned int rowIdx = 0; rowIdx < mRowCount; rowIdx++)
+	{
+		const float* pWeights = &mWeights[(size_t)rowIdx * mFeatureCount];
+		unsigned int featureIdx = 0;
+		float score = mBias[rowIdx];
+#ifdef EMOTIVLSL_SSE
+		__m128 sum = _mm_setzero_ps();
+		for (; featureIdx + 4 <= mFeatureCount; featureIdx += 4)
+		{
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pWeights + featureIdx), _mm_loadu_ps(pFeatures + featureIdx)));
+		}
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+		score += _mm_cvtss_f32(sum);
+#endif
+		for (; featureIdx < mFeatureCount; featureIdx++)
+		{
+			score += pWeights[featureIdx] * pFeatures[featureIdx];
+		}
+		pScores[rowIdx] = score;
+	}
+
+	// Binary logistic model scores the second class against the first one
+	if (mBinary)
+	{
+		pProbabilities[1] = 1.f / (1.f + std::exp(-pScores[0]));
+		pProbabilities[0] = 1.f - pProbabilities[1];
+		return;
+	}
+
+	// Softmax, shifted by maximum for stability
+	float maxScore = *std::max_element(pScores, pScores + mRowCount);
+	float sum = 0.f;
+	for (unsigned int rowIdx = 0; rowIdx < mRowCount; rowIdx++)
+	{
+		pProbabilities[rowIdx] = std::exp(pScores[rowIdx] - maxScore);
+		sum += pProbabilities[rowIdx];
+	}
+	for (unsigned int rowIdx = 0; rowIdx < mRowCount; rowIdx++)
+	{
+		pProbabilities[rowIdx] /= sum;
+	}
+}
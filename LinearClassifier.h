@@ -0,0 +1,72 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Linear classifier evaluated on feature vectors, e.g. trained by LDA or
+// logistic regression. Features are normalized, then every class gets a score
+// as weighted sum plus bias, and the scores are turned into probabilities by
+// softmax. A single weight row is a binary logistic model giving the
+// probability of the second class. Models are text files:
+//
+//   # comment
+//   classes REST TASK
+//   mean <one value per feature>
+//   scale <one value per feature>, features are divided by it after subtracting the mean
+//   weights <one value per feature>, one line per class or a single line
+//   bias <one value per weight line>
+
+#ifndef LINEAR_CLASSIFIER_H_
+#define LINEAR_CLASSIFIER_H_
+
+#include <string>
+#include <vector>
+
+class LinearClassifier
+{
+public:
+
+	// Constructor, loads model for feature count. Throws runtime error if file is not readable or malformed
+	LinearClassifier(const std::string& rFilepath, unsigned int featureCount);
+
+	// Probability of every class for feature vector, output holds class count of values
+	void Predict(const float* pFeatures, float* pProbabilities) const;
+
+	// Labels of classes
+	const std::vector<std::string>& GetClassLabels() const { return mClassLabels; }
+
+	// Count of classes
+	unsigned int GetClassCount() const { return (unsigned int)mClassLabels.size(); }
+
+private:
+
+	// Members
+	unsigned int mFeatureCount;
+	std::vector<std::string> mClassLabels;
+	std::vector<float> mMean;
+	std::vector<float> mInverseScale;
+	std::vector<float> mWeights; // rows of feature count weights, pre-multiplied with inverse scale
+	std::vector<float> mBias; // one per row, containing contribution of mean
+	unsigned int mRowCount = 0;
+	bool mBinary = false; // single row scoring the second of two classes
+	mutable std::vector<float> mScores; // scratch for prediction
+};
+
+#endif // LINEAR_CLASSIFIER_H_
@@ -0,0 +1,94 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "MemoryBounds.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#include <fstream>
+#endif
+
+#include <algorithm>
+
+// Defines
+const int defaultMaxBuffered = 360; // default of LabStreamingLayer
+const size_t sampleOverheadInBytes = 64; // timestamp and bookkeeping of a queued sample
+const size_t stringValueInBytes = 32; // assumed size of string values
+
+int GetOutletMaxBuffered(const lsl::stream_info& rInfo, const Config& rConfig)
+{
+	// Limit of stream overrides the one of all outlets
+	double limitInMiB = rConfig.GetDouble("outletMemoryLimit." + rInfo.name(), rConfig.GetDouble("outletMemoryLimit", 0.0));
+	if (limitInMiB <= 0.0)
+	{
+		return defaultMaxBuffered;
+	}
+
+	// Size of a queued sample
+	size_t valueInBytes = 0;
+	switch (rInfo.channel_format())
+	{
+	case lsl::cf_float32: valueInBytes = 4; break;
+	case lsl::cf_double64: valueInBytes = 8; break;
+	case lsl::cf_string: valueInBytes = stringValueInBytes; break;
+	case lsl::cf_int32: valueInBytes = 4; break;
+	case lsl::cf_int16: valueInBytes = 2; break;
+	case lsl::cf_int8: valueInBytes = 1; break;
+	default: valueInBytes = 8; break;
+	}
+	double sampleInBytes = (double)(rInfo.channel_count() * valueInBytes + sampleOverheadInBytes);
+	double sampleCount = limitInMiB * 1024.0 * 1024.0 / sampleInBytes;
+
+	// Regular streams are buffered in seconds, irregular ones in hundreds of samples. At least one unit is kept
+	double maxBuffered = rInfo.nominal_srate() > 0.0 ? sampleCount / rInfo.nominal_srate() : sampleCount / 100.0;
+	return (int)std::max(1.0, maxBuffered);
+}
+
+std::unique_ptr<lsl::stream_outlet> CreateOutlet(const lsl::stream_info& rInfo, const Config& rConfig)
+{
+	return std::unique_ptr<lsl::stream_outlet>(new lsl::stream_outlet(rInfo, 0, GetOutletMaxBuffered(rInfo, rConfig)));
+}
+
+size_t GetResidentMemory()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return (size_t)counters.WorkingSetSize;
+	}
+	return 0;
+#else
+	// Second field of statm is the count of resident pages
+	std::ifstream statm("/proc/self/statm");
+	size_t totalPages = 0;
+	size_t residentPages = 0;
+	if (statm >> totalPages >> residentPages)
+	{
+		return residentPages * (size_t)sysconf(_SC_PAGESIZE);
+	}
+	return 0;
+#endif
+}
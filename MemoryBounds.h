@@ -0,0 +1,48 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Memory bounds of outlets and footprint of the process. LabStreamingLayer
+// queues samples for every consumer of an outlet and drops the oldest ones
+// once the queue holds max_buffered, by default 360 seconds of data. Here the
+// bound is given in MiB per outlet and consumer instead, either for all
+// outlets (outletMemoryLimit) or per stream (outletMemoryLimit.<name>), and
+// converted into max_buffered from the channel count, format and rate.
+
+#ifndef MEMORY_BOUNDS_H_
+#define MEMORY_BOUNDS_H_
+
+#include "Config.h"
+#include "lsl_cpp.h"
+
+#include <cstddef>
+#include <memory>
+
+// Value for max_buffered of stream with limits of configuration, in seconds or hundreds of samples for irregular rate
+int GetOutletMaxBuffered(const lsl::stream_info& rInfo, const Config& rConfig);
+
+// Create outlet bounded by the limit of its stream in configuration
+std::unique_ptr<lsl::stream_outlet> CreateOutlet(const lsl::stream_info& rInfo, const Config& rConfig);
+
+// Resident memory of process in bytes, zero when unknown
+size_t GetResidentMemory();
+
+#endif // MEMORY_BOUNDS_H_
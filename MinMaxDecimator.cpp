@@ -0,0 +1,108 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "MinMaxDecimator.h"
+#include "SIMD.h"
+
+#include <algorithm>
+
+MinMaxDecimator::MinMaxDecimator(unsigned int channelCount, unsigned int bucketLength) :
+	mChannelCount(channelCount),
+	mBucketLength(std::max(bucketLength, 1u)),
+	mMin(channelCount),
+	mMax(channelCount)
+{
+	Reset();
+}
+
+void MinMaxDecimator::Process(const SampleBlock& rInput, SampleBlock& rOutput)
+{
+	rOutput.Resize(2 * mChannelCount, 0);
+	unsigned int sampleCount = rInput.SampleCount();
+	unsigned int sampleIdx = 0;
+	while (sampleIdx < sampleCount)
+	{
+		// Samples belonging to current bucket
+		unsigned int takeCount = std::min(mBucketLength - mBucketFill, sampleCount - sampleIdx);
+		const float* pSamples = &rInput.values[(size_t)sampleIdx * mChannelCount];
+
+		// Bucket starts with its first sample
+		unsigned int firstIdx = 0;
+		if (mBucketFill == 0)
+		{
+			std::copy(pSamples, pSamples + mChannelCount, mMin.begin());
+			std::copy(pSamples, pSamples + mChannelCount, mMax.begin());
+			firstIdx = 1;
+		}
+
+		// Reduce channels side by side, sample after sample
+		float* pMin = mMin.data();
+		float* pMax = mMax.data();
+		unsigned int channelIdx = 0;
+#ifdef EMOTIVLSL_SSE
+		for (; channelIdx + 4 <= mChannelCount; channelIdx += 4)
+		{
+			__m128 minimum = _mm_loadu_ps(pMin + channelIdx);
+			__m128 maximum = _mm_loadu_ps(pMax + channelIdx);
+			for (unsigned int i = firstIdx; i < takeCount; i++)
+			{
+				__m128 value = _mm_loadu_ps(pSamples + (size_t)i * mChannelCount + channelIdx);
+				minimum = _mm_min_ps(minimum, value);
+				maximum = _mm_max_ps(maximum, value);
+			}
+			_mm_storeu_ps(pMin + channelIdx, minimum);
+			_mm_storeu_ps(pMax + channelIdx, maximum);
+		}
+#endif
+		for (; channelIdx < mChannelCount; channelIdx++)
+		{
+			for (unsigned int i = firstIdx; i < takeCount; i++)
+			{
+				float value = pSamples[(size_t)i * mChannelCount + channelIdx];
+				pMin[channelIdx] = std::min(pMin[channelIdx], value);
+				pMax[channelIdx] = std::max(pMax[channelIdx], value);
+			}
+		}
+		mBucketFill += takeCount;
+		sampleIdx += takeCount;
+
+		// Output complete bucket
+		if (mBucketFill == mBucketLength)
+		{
+			unsigned int bucketIdx = rOutput.SampleCount();
+			rOutput.Resize(2 * mChannelCount, bucketIdx + 1);
+			float* pOutput = &rOutput.values[(size_t)bucketIdx * 2 * mChannelCount];
+			for (channelIdx = 0; channelIdx < mChannelCount; channelIdx++)
+			{
+				pOutput[2 * channelIdx] = pMin[channelIdx];
+				pOutput[2 * channelIdx + 1] = pMax[channelIdx];
+			}
+			rOutput.timestamps[bucketIdx] = rInput.timestamps[sampleIdx - 1];
+			mBucketFill = 0;
+		}
+	}
+}
+
+void MinMaxDecimator::Reset()
+{
+	mBucketFill = 0;
+}
@@ -0,0 +1,58 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Decimation for previews. Samples are grouped into buckets of fixed length
+// and every bucket is reduced to the minimum and maximum of each channel, so
+// spikes remain visible at a fraction of the rate, unlike when just every
+// n-th sample is kept. Buckets may span several blocks.
+
+#ifndef MIN_MAX_DECIMATOR_H_
+#define MIN_MAX_DECIMATOR_H_
+
+#include "SampleBlock.h"
+
+class MinMaxDecimator
+{
+public:
+
+	// Constructor with count of samples per bucket
+	MinMaxDecimator(unsigned int channelCount, unsigned int bucketLength);
+
+	// Reduce samples of input block. Output block is replaced by one sample per bucket completed
+	// within the block, holding minimum and maximum of each channel next to each other and
+	// stamped with the last sample of the bucket
+	void Process(const SampleBlock& rInput, SampleBlock& rOutput);
+
+	// Forget about partial bucket
+	void Reset();
+
+private:
+
+	// Members
+	unsigned int mChannelCount;
+	unsigned int mBucketLength;
+	unsigned int mBucketFill = 0; // samples in current bucket
+	std::vector<float> mMin; // of current bucket
+	std::vector<float> mMax;
+};
+
+#endif // MIN_MAX_DECIMATOR_H_
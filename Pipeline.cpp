@@ -0,0 +1,292 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "Pipeline.h"
+#include "lsl_cpp.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Defines
+const int pipelineInputRaw = -1;
+const int pipelineInputMain = -2;
+
+Pipeline::Pipeline(std::shared_ptr<WorkStealingPool> spPool, unsigned int queueCapacity) :
+	mspPool(spPool),
+	mSlots(std::max(queueCapacity, 1u))
+{
+}
+
+Pipeline::~Pipeline()
+{
+	Drain();
+}
+
+void Pipeline::AddStage(const std::string& rName, const std::string& rInput, ProcessFunction process, WantedFunction wanted, ResetFunction reset)
+{
+	std::unique_ptr<Stage> upStage(new Stage);
+	upStage->name = rName;
+	upStage->inputName = rInput;
+	upStage->process = process;
+	upStage->wanted = wanted;
+	upStage->reset = reset;
+	mStages.push_back(std::move(upStage));
+}
+
+void Pipeline::Finalize()
+{
+	// Resolve inputs by name
+	for (unsigned int stageIdx = 0; stageIdx < mStages.size(); stageIdx++)
+	{
+		Stage& rStage = *mStages[stageIdx];
+		if (rStage.inputName == pipelineSourceRaw)
+		{
+			rStage.input = pipelineInputRaw;
+			continue;
+		}
+		if (rStage.inputName == pipelineSourceMain)
+		{
+			rStage.input = pipelineInputMain;
+			continue;
+		}
+		auto it = std::find_if(mStages.begin(), mStages.end(),
+			[&rStage](const std::unique_ptr<Stage>& rupOther) { return rupOther->name == rStage.inputName; });
+		if (it == mStages.end())
+		{
+			throw std::runtime_error("Unknown input of pipeline stage " + rStage.name + ": " + rStage.inputName);
+		}
+		rStage.input = (int)(it - mStages.begin());
+		mStages[rStage.input]->dependents.push_back(stageIdx);
+	}
+
+	// Depth along inputs. As every stage has one input, a path longer than the count of stages is a cycle
+	std::vector<unsigned int> depths(mStages.size(), 0);
+	for (unsigned int stageIdx = 0; stageIdx < mStages.size(); stageIdx++)
+	{
+		int input = mStages[stageIdx]->input;
+		while (input >= 0)
+		{
+			if (++depths[stageIdx] > mStages.size())
+			{
+				throw std::runtime_error("Pipeline stages form a cycle at " + mStages[stageIdx]->name);
+			}
+			input = mStages[input]->input;
+		}
+	}
+
+	// Order stages after their inputs
+	mOrder.resize(mStages.size());
+	for (unsigned int stageIdx = 0; stageIdx < mStages.size(); stageIdx++)
+	{
+		mOrder[stageIdx] = stageIdx;
+	}
+	std::stable_sort(mOrder.begin(), mOrder.end(), [&depths](unsigned int i, unsigned int j) { return depths[i] < depths[j]; });
+}
+
+bool Pipeline::Submit(const SampleBlock& rRaw, const SampleBlock& rMain)
+{
+	if (mStages.empty())
+	{
+		return true;
+	}
+
+	// Nothing to copy when no stage is wanted. Stages start over when wanted again
+	bool wanted = false;
+	for (const auto& rupStage : mStages)
+	{
+		wanted |= rupStage->wanted();
+	}
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (!wanted)
+	{
+		mGap = true;
+		return true;
+	}
+	if (mQueuedCount == mSlots.size())
+	{
+		mGap = true;
+		mDroppedBlockCount.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	// Copy into free slot, reusing its memory
+	Slot& rSlot = mSlots[(mHead + mQueuedCount) % mSlots.size()];
+	rSlot.raw = rRaw;
+	rSlot.mainIsRaw = &rMain == &rRaw;
+	if (!rSlot.mainIsRaw)
+	{
+		rSlot.main = rMain;
+	}
+	rSlot.gapBefore = mGap;
+	rSlot.submitTime = lsl::local_clock();
+	mGap = false;
+	mQueuedCount++;
+
+	// Stages busy with an earlier block start this one when done
+	if (mBusy)
+	{
+		return true;
+	}
+	mBusy = true;
+	lock.unlock();
+	StartBlock();
+	return true;
+}
+
+void Pipeline::Drain()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mIdle.wait(lock, [this]() { return !mBusy; });
+}
+
+void Pipeline::StartBlock()
+{
+	const Slot& rSlot = mSlots[mHead];
+
+	// Stage runs when wanted or when a dependent stage runs, so decide from the back
+	unsigned int runCount = 0;
+	for (auto it = mOrder.rbegin(); it != mOrder.rend(); ++it)
+	{
+		Stage& rStage = *mStages[*it];
+		rStage.run = rStage.wanted();
+		for (unsigned int dependentIdx : rStage.dependents)
+		{
+			rStage.run |= mStages[dependentIdx]->run;
+		}
+		rStage.resume = rStage.run && (!rStage.ranBefore || rSlot.gapBefore);
+		rStage.ranBefore = rStage.run;
+		runCount += rStage.run ? 1 : 0;
+	}
+	if (runCount == 0)
+	{
+		FinishBlock();
+		return;
+	}
+
+	// Stages fed by sources start, the others follow their inputs
+	mRemaining = runCount;
+	for (unsigned int stageIdx : mOrder)
+	{
+		const Stage& rStage = *mStages[stageIdx];
+		if (rStage.input < 0 && rStage.run)
+		{
+			Schedule(stageIdx);
+		}
+	}
+}
+
+void Pipeline::RunStage(unsigned int stageIdx)
+{
+	Stage& rStage = *mStages[stageIdx];
+	const Slot& rSlot = mSlots[mHead];
+	const SampleBlock* pInput = nullptr;
+	switch (rStage.input)
+	{
+	case pipelineInputRaw:
+		pInput = &rSlot.raw;
+		break;
+	case pipelineInputMain:
+		pInput = rSlot.mainIsRaw ? &rSlot.raw : &rSlot.main;
+		break;
+	default:
+		pInput = mStages[rStage.input]->pOutput;
+		break;
+	}
+
+	// Process block, state from before skipped blocks is dropped
+	if (rStage.resume && rStage.reset)
+	{
+		rStage.reset();
+	}
+	double startTime = lsl::local_clock();
+	rStage.pOutput = rStage.process(*pInput);
+	rStage.timing.Add(lsl::local_clock() - startTime);
+
+	// Dependent stages without input are done for this block, together with their own dependents
+	unsigned int doneCount = 1;
+	for (unsigned int dependentIdx : rStage.dependents)
+	{
+		if (!mStages[dependentIdx]->run)
+		{
+			continue;
+		}
+		if (rStage.pOutput)
+		{
+			Schedule(dependentIdx);
+		}
+		else
+		{
+			doneCount += CountRunning(dependentIdx);
+		}
+	}
+	Complete(doneCount);
+}
+
+void Pipeline::Schedule(unsigned int stageIdx)
+{
+	if (mspPool)
+	{
+		mspPool->Submit([this, stageIdx]() { RunStage(stageIdx); });
+	}
+	else
+	{
+		RunStage(stageIdx);
+	}
+}
+
+unsigned int Pipeline::CountRunning(unsigned int stageIdx) const
+{
+	unsigned int count = 1;
+	for (unsigned int dependentIdx : mStages[stageIdx]->dependents)
+	{
+		if (mStages[dependentIdx]->run)
+		{
+			count += CountRunning(dependentIdx);
+		}
+	}
+	return count;
+}
+
+void Pipeline::Complete(unsigned int stageCount)
+{
+	if (mRemaining.fetch_sub(stageCount) == stageCount)
+	{
+		FinishBlock();
+	}
+}
+
+void Pipeline::FinishBlock()
+{
+	mLatency.Add(lsl::local_clock() - mSlots[mHead].submitTime);
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mHead = (mHead + 1) % mSlots.size();
+		mQueuedCount--;
+		if (mQueuedCount == 0)
+		{
+			mBusy = false;
+			mIdle.notify_all();
+			return;
+		}
+	}
+	StartBlock();
+}
@@ -0,0 +1,165 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Graph of processing stages fed by the EEG blocks of one device. Every stage
+// takes its input from a source, i.e. the EEG as acquired (raw) or as pushed
+// to the main stream (main), or from the output of another stage, so stages
+// form a directed acyclic graph. Blocks are copied on submission and the
+// stages run afterwards, so publishing of the main stream never waits for
+// them. With a pool, stages of a block run on its workers and those not
+// depending on each other run in parallel. Blocks enter the graph one after
+// another, so every stage sees them in order. Without pool, stages run on the
+// submitting thread. A stage only runs when its output is wanted, itself or
+// by a running dependent stage. When it skipped blocks, it is reset first.
+
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include "LatencyMonitor.h"
+#include "SampleBlock.h"
+#include "WorkStealingPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Defines
+const std::string pipelineSourceRaw = "raw"; // EEG as acquired
+const std::string pipelineSourceMain = "main"; // EEG as pushed to the main stream
+
+class Pipeline
+{
+public:
+
+	// Process input block. Returns output for dependent stages, null if there is none for the block
+	typedef std::function<const SampleBlock*(const SampleBlock&)> ProcessFunction;
+
+	// Whether output of stage has consumers on its own
+	typedef std::function<bool()> WantedFunction;
+
+	// Start over with fresh state
+	typedef std::function<void()> ResetFunction;
+
+	// Constructor with pool to run stages on, null to run them on submitting thread, and count of
+	// blocks that may wait for the stages. Further blocks are dropped by the stages
+	Pipeline(std::shared_ptr<WorkStealingPool> spPool, unsigned int queueCapacity);
+
+	// Destructor, waits for stages to finish
+	~Pipeline();
+
+	// Add stage with name and name of its input, either a source or another stage. Reset is optional
+	void AddStage(const std::string& rName, const std::string& rInput, ProcessFunction process, WantedFunction wanted, ResetFunction reset = nullptr);
+
+	// Resolve inputs of stages. Must be called after all stages are added. Throws runtime error if an
+	// input is unknown or stages form a cycle
+	void Finalize();
+
+	// Hand block over to stages, with the block pushed to the main stream, which may be the same.
+	// Blocks are copied, so they can be released afterwards. Returns false if block has been dropped
+	bool Submit(const SampleBlock& rRaw, const SampleBlock& rMain);
+
+	// Wait until stages have processed all submitted blocks
+	void Drain();
+
+	// Count of stages
+	unsigned int GetStageCount() const { return (unsigned int)mStages.size(); }
+
+	// Name of stage
+	const std::string& GetStageName(unsigned int stageIdx) const { return mStages[stageIdx]->name; }
+
+	// Seconds of processing per block of stage
+	LatencyMonitor& GetStageTiming(unsigned int stageIdx) { return mStages[stageIdx]->timing; }
+
+	// Seconds from submission of block until all stages have processed it
+	LatencyMonitor& GetLatency() { return mLatency; }
+
+	// Count of blocks dropped because stages fell behind
+	unsigned long long GetDroppedBlockCount() const { return mDroppedBlockCount.load(std::memory_order_relaxed); }
+
+private:
+
+	// Node of the graph
+	struct Stage
+	{
+		std::string name;
+		std::string inputName;
+		int input = 0; // index of stage or one of the sources
+		std::vector<unsigned int> dependents;
+		ProcessFunction process;
+		WantedFunction wanted;
+		ResetFunction reset;
+		bool run = false; // whether stage runs for current block
+		bool ranBefore = false; // whether stage ran for previous block
+		bool resume = false; // whether stage is reset before processing current block
+		const SampleBlock* pOutput = nullptr; // output for current block
+		LatencyMonitor timing;
+	};
+
+	// Copy of submitted block
+	struct Slot
+	{
+		SampleBlock raw;
+		SampleBlock main;
+		bool mainIsRaw = true;
+		bool gapBefore = false; // whether blocks before have been dropped or skipped
+		double submitTime = 0.0;
+	};
+
+	// Decide which stages run for oldest queued block and start those fed by sources
+	void StartBlock();
+
+	// Run stage for current block, then start its dependent stages
+	void RunStage(unsigned int stageIdx);
+
+	// Run stage on pool or right away
+	void Schedule(unsigned int stageIdx);
+
+	// Count of running stages in subtree of stage, including itself
+	unsigned int CountRunning(unsigned int stageIdx) const;
+
+	// Mark count of stages as done for current block. Last one finishes the block
+	void Complete(unsigned int stageCount);
+
+	// Remove current block from queue and start the next one, if any
+	void FinishBlock();
+
+	// Members
+	std::shared_ptr<WorkStealingPool> mspPool;
+	std::vector<std::unique_ptr<Stage> > mStages;
+	std::vector<unsigned int> mOrder; // stages after their inputs
+	std::vector<Slot> mSlots; // queued blocks, oldest at head
+	size_t mHead = 0;
+	size_t mQueuedCount = 0;
+	bool mBusy = false; // whether stages work on a block
+	bool mGap = false; // whether next queued block follows dropped or skipped ones
+	std::mutex mMutex; // guards queue
+	std::condition_variable mIdle;
+	std::atomic<unsigned int> mRemaining{ 0 }; // stages not yet done with current block
+	std::atomic<unsigned long long> mDroppedBlockCount{ 0 };
+	LatencyMonitor mLatency;
+};
+
+#endif // PIPELINE_H_
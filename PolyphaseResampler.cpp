@@ -0,0 +1,184 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "PolyphaseResampler.h"
+#include "SIMD.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Defines
+const double pi = 3.14159265358979323846;
+const double kaiserBeta = 8.0; // about 80 dB stopband attenuation
+const double cutoffFactor = 0.9; // cutoff relative to the lower of both Nyquist frequencies
+
+// Modified Bessel function of first kind and order zero, used by the Kaiser window
+static double BesselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	for (int k = 1; k < 50; k++)
+	{
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+		if (term < sum * 1e-12) { break; }
+	}
+	return sum;
+}
+
+// Greatest common divisor
+static unsigned int GreatestCommonDivisor(unsigned int a, unsigned int b)
+{
+	while (b != 0)
+	{
+		unsigned int t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+void ReduceRateFraction(unsigned int inputRate, unsigned int outputRate, unsigned int& rUp, unsigned int& rDown)
+{
+	unsigned int divisor = GreatestCommonDivisor(inputRate, outputRate);
+	rUp = outputRate / divisor;
+	rDown = inputRate / divisor;
+}
+
+PolyphaseResampler::PolyphaseResampler(unsigned int channelCount, double inputRate, unsigned int up, unsigned int down, unsigned int tapsPerPhase) :
+	mChannelCount(channelCount),
+	mInputRate(inputRate),
+	mUp(std::max(up, 1u)),
+	mDown(std::max(down, 1u)),
+	mTapsPerPhase(std::max(tapsPerPhase, 1u))
+{
+	DesignFilter();
+	Reset();
+}
+
+void PolyphaseResampler::Process(const SampleBlock& rInput, SampleBlock& rOutput)
+{
+	unsigned int inputCount = rInput.SampleCount();
+	unsigned int historyCount = mTapsPerPhase - 1;
+	rOutput.channelCount = mChannelCount;
+	rOutput.Clear();
+	if (inputCount == 0)
+	{
+		return;
+	}
+
+	// Append input to the retained history
+	mHistory.resize((size_t)(historyCount + inputCount) * mChannelCount);
+	std::memcpy(&mHistory[(size_t)historyCount * mChannelCount], rInput.values.data(), sizeof(float) * inputCount * mChannelCount);
+
+	// Produce output samples as long as their newest input sample is available
+	double groupDelay = GetGroupDelay();
+	double upsampledInterval = 1.0 / (mInputRate * mUp);
+	while (mPosition < (unsigned long long)inputCount * mUp)
+	{
+		unsigned int inputIdx = (unsigned int)(mPosition / mUp);
+		unsigned int phase = (unsigned int)(mPosition % mUp);
+
+		// Append zeroed output sample
+		size_t offset = rOutput.values.size();
+		rOutput.values.resize(offset + mChannelCount, 0.f);
+		float* pOutput = &rOutput.values[offset];
+
+		// Multiply-accumulate taps of phase with input samples, newest first. All
+		// channels share the tap, so the channels are processed side by side
+		const float* pTaps = &mPhaseTaps[(size_t)phase * mTapsPerPhase];
+		const float* pNewest = &mHistory[(size_t)(historyCount + inputIdx) * mChannelCount];
+		for (unsigned int k = 0; k < mTapsPerPhase; k++)
+		{
+			const float* pSample = pNewest - (size_t)k * mChannelCount;
+			unsigned int channelIdx = 0;
+#ifdef EMOTIVLSL_SSE
+			__m128 tap = _mm_set1_ps(pTaps[k]);
+			for (; channelIdx + 4 <= mChannelCount; channelIdx += 4)
+			{
+				__m128 accumulator = _mm_loadu_ps(pOutput + channelIdx);
+				accumulator = _mm_add_ps(accumulator, _mm_mul_ps(tap, _mm_loadu_ps(pSample + channelIdx)));
+				_mm_storeu_ps(pOutput + channelIdx, accumulator);
+			}
+#endif
+			for (; channelIdx < mChannelCount; channelIdx++)
+			{
+				pOutput[channelIdx] += pTaps[k] * pSample[channelIdx];
+			}
+		}
+
+		// Timestamp from the input sample, shifted by phase and corrected by filter delay
+		rOutput.timestamps.push_back(rInput.timestamps[inputIdx] + phase * upsampledInterval - groupDelay);
+		mPosition += mDown;
+	}
+	mPosition -= (unsigned long long)inputCount * mUp;
+
+	// Keep newest samples as history for next block
+	std::memmove(mHistory.data(), &mHistory[(size_t)inputCount * mChannelCount], sizeof(float) * historyCount * mChannelCount);
+	mHistory.resize((size_t)historyCount * mChannelCount);
+}
+
+void PolyphaseResampler::Reset()
+{
+	mHistory.assign((size_t)(mTapsPerPhase - 1) * mChannelCount, 0.f);
+	mPosition = 0;
+}
+
+double PolyphaseResampler::GetGroupDelay() const
+{
+	// Symmetric filter delays by half its length on the upsampled grid
+	double filterLength = (double)mUp * mTapsPerPhase;
+	return ((filterLength - 1.0) / 2.0) / (mInputRate * mUp);
+}
+
+void PolyphaseResampler::DesignFilter()
+{
+	// Cutoff in cycles per upsampled sample
+	unsigned int length = mUp * mTapsPerPhase;
+	double cutoff = cutoffFactor * 0.5 / std::max(mUp, mDown);
+	double center = (length - 1) / 2.0;
+	double windowNorm = BesselI0(kaiserBeta);
+
+	// Windowed sinc
+	std::vector<double> filter(length);
+	double sum = 0.0;
+	for (unsigned int n = 0; n < length; n++)
+	{
+		double t = n - center;
+		double sinc = (t == 0.0) ? 2.0 * cutoff : std::sin(2.0 * pi * cutoff * t) / (pi * t);
+		double ratio = (length > 1) ? (2.0 * n / (length - 1) - 1.0) : 0.0;
+		double window = BesselI0(kaiserBeta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / windowNorm;
+		filter[n] = sinc * window;
+		sum += filter[n];
+	}
+
+	// Normalize to gain of up, compensating the zeros inserted by upsampling, and split into phases
+	mPhaseTaps.resize(length);
+	for (unsigned int phase = 0; phase < mUp; phase++)
+	{
+		for (unsigned int k = 0; k < mTapsPerPhase; k++)
+		{
+			mPhaseTaps[(size_t)phase * mTapsPerPhase + k] = (float)(filter[phase + (size_t)k * mUp] * mUp / sum);
+		}
+	}
+}
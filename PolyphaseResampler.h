@@ -0,0 +1,77 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Streaming resampler by a rational factor up / down. The anti-aliasing filter
+// is a Kaiser windowed sinc of up * tapsPerPhase taps, split into up phases so
+// only the taps needed for an output sample are evaluated. Blocks can have any
+// size, state between blocks is limited to tapsPerPhase - 1 input samples.
+
+#ifndef POLYPHASE_RESAMPLER_H_
+#define POLYPHASE_RESAMPLER_H_
+
+#include "SampleBlock.h"
+
+class PolyphaseResampler
+{
+public:
+
+	// Constructor, resampling from input rate to input rate * up / down
+	PolyphaseResampler(unsigned int channelCount, double inputRate, unsigned int up, unsigned int down, unsigned int tapsPerPhase);
+
+	// Resample input block. Output block is replaced by resampled samples, which
+	// may be empty when the input is too short to produce an output sample
+	void Process(const SampleBlock& rInput, SampleBlock& rOutput);
+
+	// Forget about previous samples, e.g. after a gap in the input
+	void Reset();
+
+	// Delay of the filter in seconds. Output timestamps are already corrected by it,
+	// so it only tells how much later than the raw data a sample becomes available
+	double GetGroupDelay() const;
+
+	// Rate of output in Hz
+	double GetOutputRate() const { return mInputRate * mUp / mDown; }
+
+	// Getters for the factor
+	unsigned int GetUp() const { return mUp; }
+	unsigned int GetDown() const { return mDown; }
+
+private:
+
+	// Design lowpass filter and split it into phases
+	void DesignFilter();
+
+	// Members
+	unsigned int mChannelCount;
+	double mInputRate;
+	unsigned int mUp;
+	unsigned int mDown;
+	unsigned int mTapsPerPhase;
+	std::vector<float> mPhaseTaps; // up rows of tapsPerPhase taps, row p holds filter[p + k * up]
+	std::vector<float> mHistory; // previous tapsPerPhase - 1 samples followed by current input, interleaved
+	unsigned long long mPosition = 0; // position of next output on upsampled grid, relative to first input sample of block
+};
+
+// Reduce fraction of two rates, e.g. 128 Hz to 250 Hz gives up = 125 and down = 64
+void ReduceRateFraction(unsigned int inputRate, unsigned int outputRate, unsigned int& rUp, unsigned int& rDown);
+
+#endif // POLYPHASE_RESAMPLER_H_
@@ -0,0 +1,131 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "Realtime.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#include <cstring>
+
+std::thread::native_handle_type CurrentThreadHandle()
+{
+#ifdef _WIN32
+	return GetCurrentThread();
+#else
+	return pthread_self();
+#endif
+}
+
+bool SetThreadRealtimePriority(std::thread::native_handle_type thread, int priority)
+{
+#ifdef _WIN32
+	// Windows has no priority levels in between, real-time class of process is left alone
+	return SetThreadPriority(thread, priority > 0 ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_NORMAL) != 0;
+#else
+	sched_param parameter;
+	std::memset(&parameter, 0, sizeof(parameter));
+	parameter.sched_priority = priority;
+	return pthread_setschedparam(thread, priority > 0 ? SCHED_FIFO : SCHED_OTHER, &parameter) == 0;
+#endif
+}
+
+bool SetThreadAffinity(std::thread::native_handle_type thread, int cpu)
+{
+	if (cpu < 0)
+	{
+		return false;
+	}
+#ifdef _WIN32
+	return cpu < 32 && SetThreadAffinityMask(thread, (DWORD_PTR)1 << cpu) != 0;
+#else
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(cpu, &cpuSet);
+	return pthread_setaffinity_np(thread, sizeof(cpuSet), &cpuSet) == 0;
+#endif
+}
+
+bool LockMemory()
+{
+#ifdef _WIN32
+	// Closest equivalent is a working set large enough to keep the process resident
+	const SIZE_T workingSetSize = 256 * 1024 * 1024;
+	return SetProcessWorkingSetSize(GetCurrentProcess(), workingSetSize / 2, workingSetSize) != 0;
+#else
+	return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+#endif
+}
+
+void PrefaultStack(size_t byteCount)
+{
+	// Volatile keeps the compiler from removing the writes
+	volatile unsigned char* pStack = (volatile unsigned char*)alloca(byteCount);
+	for (size_t i = 0; i < byteCount; i += 4096)
+	{
+		pStack[i] = 0;
+	}
+}
+
+DeadlineTimer::DeadlineTimer(long long periodInMiliseconds) :
+	mPeriod(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::milliseconds(periodInMiliseconds))),
+	mDeadline(std::chrono::steady_clock::now() + mPeriod)
+{
+}
+
+void DeadlineTimer::Wait()
+{
+	std::this_thread::sleep_until(mDeadline);
+	std::chrono::steady_clock::time_point wakeup = std::chrono::steady_clock::now();
+
+	// Record lateness
+	mLastLateness = std::chrono::duration<double>(wakeup - mDeadline).count();
+	mLatenessSum += mLastLateness;
+	if (mLastLateness > mMaxLateness)
+	{
+		mMaxLateness = mLastLateness;
+	}
+	mWakeupCount++;
+
+	// Next deadline, starting over when a whole period has been missed
+	mDeadline += mPeriod;
+	if (wakeup >= mDeadline)
+	{
+		mMissedDeadlineCount++;
+		mDeadline = wakeup + mPeriod;
+	}
+}
+
+void DeadlineTimer::ResetStatistics()
+{
+	mLatenessSum = 0.0;
+	mMaxLateness = 0.0;
+	mWakeupCount = 0;
+	mMissedDeadlineCount = 0;
+}
@@ -0,0 +1,91 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Opt-in measures against scheduling latency of acquisition and publishing:
+// real-time priority, pinning of threads to a CPU and locking of memory. All
+// of them need privileges (CAP_SYS_NICE and CAP_IPC_LOCK or a suitable
+// rlimit on Linux) and report failure instead of stopping the program.
+// Loops wake up at fixed deadlines, and how late they actually wake up is
+// measured, so the effect of the measures can be seen.
+
+#ifndef REALTIME_H_
+#define REALTIME_H_
+
+#include <chrono>
+#include <thread>
+
+// Handle of calling thread
+std::thread::native_handle_type CurrentThreadHandle();
+
+// Run thread with real-time priority, where priority is between 1 and 99 as for SCHED_FIFO.
+// Returns whether successful
+bool SetThreadRealtimePriority(std::thread::native_handle_type thread, int priority);
+
+// Pin thread to a single CPU. Returns whether successful
+bool SetThreadAffinity(std::thread::native_handle_type thread, int cpu);
+
+// Lock current and future memory of process into RAM. Returns whether successful
+bool LockMemory();
+
+// Touch given count of bytes on the stack, so later growth does not cause page faults
+void PrefaultStack(size_t byteCount);
+
+// Loop timer waking up at fixed deadlines instead of sleeping a fixed duration after the
+// work, so the work does not add to the period. Lateness of every wakeup is recorded
+class DeadlineTimer
+{
+public:
+
+	// Constructor with period of loop
+	DeadlineTimer(long long periodInMiliseconds);
+
+	// Sleep until next deadline. When more than a period late, deadlines start over from now
+	void Wait();
+
+	// Lateness of last wakeup in seconds
+	double GetLastLateness() const { return mLastLateness; }
+
+	// Mean lateness of wakeups in seconds since last reset
+	double GetMeanLateness() const { return mWakeupCount > 0 ? mLatenessSum / mWakeupCount : 0.0; }
+
+	// Maximal lateness of wakeups in seconds since last reset
+	double GetMaxLateness() const { return mMaxLateness; }
+
+	// Count of wakeups later than a period, which cost an iteration
+	unsigned long long GetMissedDeadlineCount() const { return mMissedDeadlineCount; }
+
+	// Start over with statistics
+	void ResetStatistics();
+
+private:
+
+	// Members
+	std::chrono::steady_clock::duration mPeriod;
+	std::chrono::steady_clock::time_point mDeadline;
+	double mLastLateness = 0.0;
+	double mLatenessSum = 0.0;
+	double mMaxLateness = 0.0;
+	unsigned long long mWakeupCount = 0;
+	unsigned long long mMissedDeadlineCount = 0;
+};
+
+#endif // REALTIME_H_
@@ -0,0 +1,101 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "Rereference.h"
+#include "SIMD.h"
+
+Rereference::Rereference(unsigned int channelCount, const std::vector<unsigned int>& rReferenceChannels) :
+	mChannelCount(channelCount),
+	mReferenceChannelCount(0),
+	mWeights(channelCount, 0.f)
+{
+	// Mark reference channels
+	for (unsigned int channelIdx = 0; channelIdx < mChannelCount; channelIdx++)
+	{
+		bool reference = rReferenceChannels.empty();
+		for (unsigned int referenceIdx : rReferenceChannels)
+		{
+			if (referenceIdx == channelIdx) { reference = true; }
+		}
+		if (reference)
+		{
+			mWeights[channelIdx] = 1.f;
+			mReferenceChannelCount++;
+		}
+	}
+
+	// Weights average over reference channels
+	for (float& rWeight : mWeights)
+	{
+		rWeight /= (float)mReferenceChannelCount;
+	}
+}
+
+void Rereference::Process(const SampleBlock& rInput, SampleBlock& rOutput) const
+{
+	unsigned int sampleCount = rInput.SampleCount();
+	if (&rInput != &rOutput)
+	{
+		rOutput.Resize(mChannelCount, sampleCount);
+		rOutput.timestamps = rInput.timestamps;
+	}
+
+	// Go over samples
+	const float* pWeights = mWeights.data();
+	for (unsigned int sampleIdx = 0; sampleIdx < sampleCount; sampleIdx++)
+	{
+		const float* pInput = &rInput.values[(size_t)sampleIdx * mChannelCount];
+		float* pOutput = &rOutput.values[(size_t)sampleIdx * mChannelCount];
+
+		// Reference as weighted sum of channels
+		unsigned int channelIdx = 0;
+		float reference = 0.f;
+#ifdef EMOTIVLSL_SSE
+		__m128 sum = _mm_setzero_ps();
+		for (; channelIdx + 4 <= mChannelCount; channelIdx += 4)
+		{
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pWeights + channelIdx), _mm_loadu_ps(pInput + channelIdx)));
+		}
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+		reference = _mm_cvtss_f32(sum);
+#endif
+		for (; channelIdx < mChannelCount; channelIdx++)
+		{
+			reference += pWeights[channelIdx] * pInput[channelIdx];
+		}
+
+		// Subtract reference from all channels
+		channelIdx = 0;
+#ifdef EMOTIVLSL_SSE
+		__m128 broadcast = _mm_set1_ps(reference);
+		for (; channelIdx + 4 <= mChannelCount; channelIdx += 4)
+		{
+			_mm_storeu_ps(pOutput + channelIdx, _mm_sub_ps(_mm_loadu_ps(pInput + channelIdx), broadcast));
+		}
+#endif
+		for (; channelIdx < mChannelCount; channelIdx++)
+		{
+			pOutput[channelIdx] = pInput[channelIdx] - reference;
+		}
+	}
+}
@@ -0,0 +1,53 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Re-referencing of EEG. The mean of a set of reference channels is subtracted
+// from every channel of a sample. With all channels as reference this is the
+// common average reference (CAR).
+
+#ifndef REREFERENCE_H_
+#define REREFERENCE_H_
+
+#include "SampleBlock.h"
+
+class Rereference
+{
+public:
+
+	// Constructor with indices of reference channels. Empty list means common average reference
+	Rereference(unsigned int channelCount, const std::vector<unsigned int>& rReferenceChannels);
+
+	// Re-reference samples of input block into output block. Both may be the same block
+	void Process(const SampleBlock& rInput, SampleBlock& rOutput) const;
+
+	// Count of channels contributing to reference
+	unsigned int GetReferenceChannelCount() const { return mReferenceChannelCount; }
+
+private:
+
+	// Members
+	unsigned int mChannelCount;
+	unsigned int mReferenceChannelCount;
+	std::vector<float> mWeights; // one over count of reference channels where channel is part of reference, else zero
+};
+
+#endif // REREFERENCE_H_
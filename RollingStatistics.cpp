@@ -0,0 +1,116 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "RollingStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+RollingStatistics::RollingStatistics(double window) : mWindow(window)
+{
+}
+
+void RollingStatistics::Add(double value, double time)
+{
+	// Remove values that left the window, also when value is ignored
+	double windowStart = time - mWindow;
+	while (!mValues.empty() && mValues.front().time < windowStart)
+	{
+		double removed = mValues.front().value;
+		mValues.pop_front();
+		if (mValues.empty())
+		{
+			mMean = 0.0;
+			mSquaredDeviations = 0.0;
+		}
+		else
+		{
+			double delta = removed - mMean;
+			mMean -= delta / mValues.size();
+			mSquaredDeviations = std::max(mSquaredDeviations - delta * (removed - mMean), 0.0);
+		}
+	}
+	while (!mMinimums.empty() && mMinimums.front().time < windowStart) { mMinimums.pop_front(); }
+	while (!mMaximums.empty() && mMaximums.front().time < windowStart) { mMaximums.pop_front(); }
+	if (!std::isfinite(value))
+	{
+		return;
+	}
+
+	// Add value
+	Entry entry = { value, time };
+	mValues.push_back(entry);
+	double delta = value - mMean;
+	mMean += delta / mValues.size();
+	mSquaredDeviations += delta * (value - mMean);
+
+	// Values that can no longer be the minimum or maximum of the window are dropped
+	while (!mMinimums.empty() && mMinimums.back().value >= value) { mMinimums.pop_back(); }
+	mMinimums.push_back(entry);
+	while (!mMaximums.empty() && mMaximums.back().value <= value) { mMaximums.pop_back(); }
+	mMaximums.push_back(entry);
+}
+
+void RollingStatistics::Reset()
+{
+	mValues.clear();
+	mMinimums.clear();
+	mMaximums.clear();
+	mMean = 0.0;
+	mSquaredDeviations = 0.0;
+}
+
+double RollingStatistics::GetZScore(double value) const
+{
+	if (mValues.empty() || !std::isfinite(value))
+	{
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+	double deviation = GetStandardDeviation();
+	return deviation > 0.0 ? (value - mMean) / deviation : 0.0;
+}
+
+double RollingStatistics::GetWindowScaled(double value) const
+{
+	if (mValues.empty() || !std::isfinite(value))
+	{
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+	double range = GetMax() - GetMin();
+	return range > 0.0 ? (value - GetMin()) / range : 0.5;
+}
+
+double RollingStatistics::GetStandardDeviation() const
+{
+	return mValues.size() > 1 ? std::sqrt(mSquaredDeviations / (mValues.size() - 1)) : 0.0;
+}
+
+double RollingStatistics::GetMin() const
+{
+	return mMinimums.empty() ? std::numeric_limits<double>::quiet_NaN() : mMinimums.front().value;
+}
+
+double RollingStatistics::GetMax() const
+{
+	return mMaximums.empty() ? std::numeric_limits<double>::quiet_NaN() : mMaximums.front().value;
+}
@@ -0,0 +1,78 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Rolling statistics of an irregularly sampled value over a window of time,
+// e.g. a performance metric of the EmoStates. Mean and variance are updated
+// by Welford's method when values enter and leave the window, minimum and
+// maximum are kept in monotonic deques, so each value costs constant time
+// amortized. Used to normalize a value against its recent history.
+
+#ifndef ROLLING_STATISTICS_H_
+#define ROLLING_STATISTICS_H_
+
+#include <deque>
+
+class RollingStatistics
+{
+public:
+
+	// Constructor with window length in seconds
+	RollingStatistics(double window);
+
+	// Add value at time and remove values older than the window. Times must not decrease. Values that are not finite are not added
+	void Add(double value, double time);
+
+	// Forget all values, e.g. when the user changes
+	void Reset();
+
+	// Standard score of value relative to window. Zero while the window has no spread, NaN while it is empty
+	double GetZScore(double value) const;
+
+	// Position of value between minimum and maximum of window. One half while the window has no spread, NaN while it is empty
+	double GetWindowScaled(double value) const;
+
+	// Getters over values in window
+	unsigned int GetCount() const { return (unsigned int)mValues.size(); }
+	double GetMean() const { return mMean; }
+	double GetStandardDeviation() const;
+	double GetMin() const;
+	double GetMax() const;
+
+private:
+
+	// Value with its time
+	struct Entry
+	{
+		double value;
+		double time;
+	};
+
+	// Members
+	double mWindow;
+	std::deque<Entry> mValues; // all values in window, oldest first
+	std::deque<Entry> mMinimums; // increasing values, each the minimum of the window from its time on
+	std::deque<Entry> mMaximums; // decreasing values, each the maximum of the window from its time on
+	double mMean = 0.0;
+	double mSquaredDeviations = 0.0; // sum of squared deviations from mean
+};
+
+#endif // ROLLING_STATISTICS_H_
@@ -0,0 +1,71 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Block of samples as handed from acquisition to the outlets. Values are
+// interleaved (sample after sample, channels next to each other), which is
+// the layout expected by push_chunk_multiplexed of LabStreamingLayer.
+
+#ifndef SAMPLE_BLOCK_H_
+#define SAMPLE_BLOCK_H_
+
+#include <cstddef>
+#include <vector>
+
+struct SampleBlock
+{
+	// Prepare block for count of samples. Allocated memory is kept
+	void Resize(unsigned int newChannelCount, unsigned int sampleCount)
+	{
+		channelCount = newChannelCount;
+		values.resize((size_t)channelCount * sampleCount);
+		timestamps.resize(sampleCount);
+	}
+
+	// Remove all samples but keep allocated memory
+	void Clear()
+	{
+		values.clear();
+		timestamps.clear();
+	}
+
+	// Count of samples in block
+	unsigned int SampleCount() const
+	{
+		return (unsigned int)timestamps.size();
+	}
+
+	// Assign timestamps backwards from the one of the latest sample, assuming regular sampling
+	void StampBackwards(double latestTimestamp, double sampleRate)
+	{
+		unsigned int sampleCount = SampleCount();
+		for (unsigned int i = 0; i < sampleCount; i++)
+		{
+			timestamps[i] = latestTimestamp - (double)(sampleCount - 1 - i) / sampleRate;
+		}
+	}
+
+	unsigned int channelCount = 0;
+	std::vector<float> values; // interleaved channel values
+	std::vector<double> timestamps; // one timestamp per sample, in time of lsl::local_clock()
+};
+
+#endif // SAMPLE_BLOCK_H_
@@ -0,0 +1,373 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Wait-free ring of sample blocks between exactly one producer thread and one
+// consumer thread. Slots are allocated once, so handing over a block neither
+// locks nor allocates. Capacity is rounded up to a power of two, the indices
+// of both sides live on their own cache lines. When the ring is full the
+// producer is refused and the refusal is counted as overflow, when the
+// consumer finds it empty this is counted as underrun. Instead of the newest
+// block, the consumer may drop the oldest ones, or the producer may wait for
+// free slots; both are counted as well.
+//
+// Further threads may subscribe to the blocks and view them in place, without
+// copy. Subscribers never hold back the producer: each slot refers to one of
+// the preallocated buffers, and when the producer needs a slot whose buffer is
+// being viewed, it continues with a spare buffer instead. Blocks overwritten
+// before a subscriber got to them are counted as lost for that subscriber.
+
+#ifndef SAMPLE_RING_H_
+#define SAMPLE_RING_H_
+
+#include "SampleBlock.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+
+// Defines
+const size_t cacheLineSize = 64;
+
+// What happens when the producer finds the ring full
+enum RingPolicy
+{
+	RING_DROP_NEWEST, // producer is refused
+	RING_DROP_OLDEST, // consumer drops old blocks, so the producer finds room
+	RING_BLOCK // producer waits for the consumer a limited time, then it is refused
+};
+
+class SampleRing
+{
+public:
+
+	// Constructor with minimal count of slots and memory to reserve per slot. Spare
+	// buffers bound how many blocks subscribers may view at the same time
+	SampleRing(size_t minimalSlotCount, unsigned int channelCount, unsigned int maxSamplesPerBlock, size_t spareBufferCount = 4)
+	{
+		size_t slotCount = 1;
+		while (slotCount < minimalSlotCount) { slotCount <<= 1; }
+		mMask = slotCount - 1;
+		mBuffers.resize(slotCount + spareBufferCount);
+		for (SampleBlock& rBuffer : mBuffers)
+		{
+			rBuffer.channelCount = channelCount;
+			rBuffer.values.reserve((size_t)channelCount * maxSamplesPerBlock);
+			rBuffer.timestamps.reserve(maxSamplesPerBlock);
+		}
+		mPins.reset(new std::atomic<unsigned int>[mBuffers.size()]);
+		for (size_t i = 0; i < mBuffers.size(); i++)
+		{
+			mPins[i] = 0;
+		}
+
+		// Slots start with buffers of same index, the others are spare
+		mSlots.reset(new Slot[slotCount]);
+		for (size_t i = 0; i < slotCount; i++)
+		{
+			mSlots[i].position = unwrittenPosition;
+			mSlots[i].buffer = i;
+		}
+		for (size_t i = slotCount; i < mBuffers.size(); i++)
+		{
+			mSpareBuffers.push_back(i);
+		}
+	}
+
+	// Write reserved memory of all buffers once, so it is backed by physical pages before
+	// acquisition starts. Must be called before producer and consumer are running
+	void Prefault()
+	{
+		for (SampleBlock& rBuffer : mBuffers)
+		{
+			rBuffer.values.resize(rBuffer.values.capacity());
+			rBuffer.timestamps.resize(rBuffer.timestamps.capacity());
+			rBuffer.Clear();
+		}
+	}
+
+	// ### PRODUCER ###
+
+	// Reserve up to count of free slots for writing. Returns count of reserved slots,
+	// slots which could not be reserved are counted as overflow
+	size_t Reserve(size_t count)
+	{
+		size_t head = mHead.load(std::memory_order_relaxed);
+		size_t tail = mTail.load(std::memory_order_acquire);
+		size_t free = GetCapacity() - (head - tail);
+		size_t reserved = 0;
+		while (reserved < count && reserved < free && Prepare(head + reserved))
+		{
+			reserved++;
+		}
+		if (reserved < count)
+		{
+			mOverflows.fetch_add(count - reserved, std::memory_order_relaxed);
+		}
+		return reserved;
+	}
+
+	// Reserve like above, but wait up to given duration for slots to become free. Waiting is
+	// counted as block, slots still not free after waiting as overflow
+	size_t Reserve(size_t count, std::chrono::steady_clock::duration maxWait)
+	{
+		size_t head = mHead.load(std::memory_order_relaxed);
+		if (GetCapacity() - (head - mTail.load(std::memory_order_acquire)) < count)
+		{
+			mBlocks.fetch_add(1, std::memory_order_relaxed);
+			std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + maxWait;
+			while (GetCapacity() - (head - mTail.load(std::memory_order_acquire)) < count && std::chrono::steady_clock::now() < deadline)
+			{
+				std::this_thread::sleep_for(std::chrono::microseconds(500));
+			}
+		}
+		return Reserve(count);
+	}
+
+	// Access slot of reservation, index is relative to first reserved slot
+	SampleBlock& Reserved(size_t idx)
+	{
+		return At(mHead.load(std::memory_order_relaxed) + idx);
+	}
+
+	// Hand count of reserved slots over to consumer and subscribers
+	void Commit(size_t count)
+	{
+		size_t head = mHead.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < count; i++)
+		{
+			mSlots[(head + i) & mMask].position.store(head + i);
+		}
+		mHead.store(head + count, std::memory_order_release);
+	}
+
+	// ### CONSUMER ###
+
+	// Count of slots ready for reading, up to maximal count. Empty ring is counted as underrun
+	size_t Peek(size_t maxCount)
+	{
+		size_t tail = mTail.load(std::memory_order_relaxed);
+		size_t head = mHead.load(std::memory_order_acquire);
+		size_t available = head - tail;
+		if (available == 0)
+		{
+			mUnderruns.fetch_add(1, std::memory_order_relaxed);
+		}
+		return available < maxCount ? available : maxCount;
+	}
+
+	// Access slot ready for reading, index is relative to oldest slot. Subscribers may view
+	// the block at the same time, so it must not be changed
+	const SampleBlock& Peeked(size_t idx)
+	{
+		return At(mTail.load(std::memory_order_relaxed) + idx);
+	}
+
+	// Give count of read slots back to producer
+	void Release(size_t count)
+	{
+		mTail.store(mTail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+	}
+
+	// Drop oldest slots until at most count of slots is left. Returns count of dropped slots
+	size_t DropOldest(size_t keepCount)
+	{
+		size_t tail = mTail.load(std::memory_order_relaxed);
+		size_t available = mHead.load(std::memory_order_acquire) - tail;
+		if (available <= keepCount)
+		{
+			return 0;
+		}
+		size_t dropped = available - keepCount;
+		mDroppedOldest.fetch_add(dropped, std::memory_order_relaxed);
+		mTail.store(tail + dropped, std::memory_order_release);
+		return dropped;
+	}
+
+	// ### STATISTICS ###
+
+	// Count of slots in ring
+	size_t GetCapacity() const { return mMask + 1; }
+
+	// Count of slots currently filled, may be outdated when called by neither side
+	size_t GetFill() const { return mHead.load(std::memory_order_acquire) - mTail.load(std::memory_order_acquire); }
+
+	// Count of blocks refused because ring was full
+	uint64_t GetOverflows() const { return mOverflows.load(std::memory_order_relaxed); }
+
+	// Count of reads on empty ring
+	uint64_t GetUnderruns() const { return mUnderruns.load(std::memory_order_relaxed); }
+
+	// Count of times the producer waited for free slots
+	uint64_t GetBlocks() const { return mBlocks.load(std::memory_order_relaxed); }
+
+	// Count of blocks dropped by the consumer to make room
+	uint64_t GetDroppedOldest() const { return mDroppedOldest.load(std::memory_order_relaxed); }
+
+private:
+
+	friend class SampleSubscription;
+
+	// Slot refers to the buffer holding its block and tells which position the block has
+	struct Slot
+	{
+		std::atomic<size_t> position; // unwritten while producer may write to buffer
+		std::atomic<size_t> buffer;
+	};
+
+	// Marker of slots the producer writes to
+	static const size_t unwrittenPosition = std::numeric_limits<size_t>::max();
+
+	// Buffer of slot at position
+	SampleBlock& At(size_t position)
+	{
+		return mBuffers[mSlots[position & mMask].buffer.load(std::memory_order_relaxed)];
+	}
+
+	// Make slot for position writable. Its buffer is exchanged for a spare one when a subscriber
+	// views it. Returns false when all spare buffers are viewed as well
+	bool Prepare(size_t position)
+	{
+		// Sequentially consistent with Pin, so either the subscriber sees the slot as unwritten or
+		// the producer sees the pin
+		Slot& rSlot = mSlots[position & mMask];
+		rSlot.position.store(unwrittenPosition);
+		size_t buffer = rSlot.buffer.load();
+		if (mPins[buffer].load() == 0)
+		{
+			return true;
+		}
+		for (size_t& rSpareBuffer : mSpareBuffers)
+		{
+			if (mPins[rSpareBuffer].load() == 0)
+			{
+				rSlot.buffer.store(rSpareBuffer);
+				rSpareBuffer = buffer;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Pin buffer of block at position for viewing. Returns false when block is not there (anymore)
+	bool Pin(size_t position, size_t& rBuffer)
+	{
+		Slot& rSlot = mSlots[position & mMask];
+		if (rSlot.position.load() != position)
+		{
+			return false;
+		}
+		rBuffer = rSlot.buffer.load();
+		mPins[rBuffer].fetch_add(1);
+
+		// Producer may have started to overwrite the slot meanwhile
+		if (rSlot.position.load() != position || rSlot.buffer.load() != rBuffer)
+		{
+			mPins[rBuffer].fetch_sub(1);
+			return false;
+		}
+		return true;
+	}
+
+	// Members, indices and counters of both sides are kept apart to avoid false sharing
+	std::vector<SampleBlock> mBuffers;
+	std::unique_ptr<std::atomic<unsigned int>[]> mPins; // count of subscribers viewing each buffer
+	std::unique_ptr<Slot[]> mSlots;
+	size_t mMask;
+	std::vector<size_t> mSpareBuffers; // only accessed by producer
+	alignas(cacheLineSize) std::atomic<size_t> mHead{ 0 }; // written by producer
+	alignas(cacheLineSize) std::atomic<uint64_t> mOverflows{ 0 }; // written by producer
+	std::atomic<uint64_t> mBlocks{ 0 }; // written by producer
+	alignas(cacheLineSize) std::atomic<size_t> mTail{ 0 }; // written by consumer
+	alignas(cacheLineSize) std::atomic<uint64_t> mUnderruns{ 0 }; // written by consumer
+	std::atomic<uint64_t> mDroppedOldest{ 0 }; // written by consumer
+};
+
+// Subscription to the blocks of a ring, used by one thread. Blocks are viewed in place,
+// one at a time, from the newest block at subscription on
+class SampleSubscription
+{
+public:
+
+	// Constructor
+	SampleSubscription(SampleRing& rRing) : mrRing(rRing), mCursor(rRing.mHead.load(std::memory_order_acquire)) {}
+
+	// Destructor, releases view
+	~SampleSubscription() { Release(); }
+
+	// View next block, null when there is none yet. Previous view is released. Blocks
+	// overwritten before they could be viewed are skipped and counted as lost
+	const SampleBlock* Next()
+	{
+		Release();
+		size_t head = mrRing.mHead.load(std::memory_order_acquire);
+		while (mCursor != head)
+		{
+			// Blocks further behind than the ring holds are gone for sure
+			if (head - mCursor > mrRing.GetCapacity())
+			{
+				mLostCount.fetch_add(head - mCursor - mrRing.GetCapacity(), std::memory_order_relaxed);
+				mCursor = head - mrRing.GetCapacity();
+			}
+			size_t position = mCursor++;
+			if (mrRing.Pin(position, mBuffer))
+			{
+				mViewedCount.fetch_add(1, std::memory_order_relaxed);
+				return &mrRing.mBuffers[mBuffer];
+			}
+			mLostCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		return nullptr;
+	}
+
+	// Release current view, so its buffer can be written again
+	void Release()
+	{
+		if (mBuffer != noBuffer)
+		{
+			mrRing.mPins[mBuffer].fetch_sub(1);
+			mBuffer = noBuffer;
+		}
+	}
+
+	// Count of blocks viewed
+	uint64_t GetViewedCount() const { return mViewedCount.load(std::memory_order_relaxed); }
+
+	// Count of blocks lost because the subscriber was too slow
+	uint64_t GetLostCount() const { return mLostCount.load(std::memory_order_relaxed); }
+
+private:
+
+	// Marker of no current view
+	static const size_t noBuffer = std::numeric_limits<size_t>::max();
+
+	// Members
+	SampleRing& mrRing;
+	size_t mCursor; // position of next block to view
+	size_t mBuffer = noBuffer; // buffer currently viewed
+	std::atomic<uint64_t> mViewedCount{ 0 };
+	std::atomic<uint64_t> mLostCount{ 0 };
+};
+
+#endif // SAMPLE_RING_H_
@@ -0,0 +1,80 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "SampleSubscriber.h"
+
+#include <chrono>
+#include <exception>
+
+// Defines
+const long long subscriberIdleInMiliseconds = 2; // sleep when no block is new
+
+SampleSubscriber::SampleSubscriber(SampleRing& rRing, BlockCallback callback) : mSubscription(rRing), mCallback(callback)
+{
+	mThread = std::thread(&SampleSubscriber::Run, this);
+}
+
+SampleSubscriber::~SampleSubscriber()
+{
+	mRunning = false;
+	if (mThread.joinable())
+	{
+		mThread.join();
+	}
+}
+
+std::string SampleSubscriber::GetError() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mError;
+}
+
+void SampleSubscriber::Run()
+{
+	// No exception of the callback may leave the thread
+	try
+	{
+		while (mRunning.load())
+		{
+			const SampleBlock* pBlock = mSubscription.Next();
+			if (!pBlock)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(subscriberIdleInMiliseconds));
+				continue;
+			}
+			mCallback(*pBlock);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mError = e.what();
+		mFailed = true;
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mError = "Unknown exception in sample callback";
+		mFailed = true;
+	}
+	mSubscription.Release();
+}
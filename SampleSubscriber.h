@@ -0,0 +1,77 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Thread handing each block of a ring to a callback, viewed in place. A slow
+// callback only makes this subscriber lose blocks, which are counted; neither
+// acquisition nor publishing wait for it. An exception of the callback ends the
+// thread and is kept as error.
+
+#ifndef SAMPLE_SUBSCRIBER_H_
+#define SAMPLE_SUBSCRIBER_H_
+
+#include "SampleRing.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class SampleSubscriber
+{
+public:
+
+	// Callback receiving a block, which is only valid during the call and must not be changed
+	typedef std::function<void(const SampleBlock&)> BlockCallback;
+
+	// Constructor, starts thread viewing blocks committed from now on
+	SampleSubscriber(SampleRing& rRing, BlockCallback callback);
+
+	// Destructor, stops thread
+	~SampleSubscriber();
+
+	// Counts of blocks handed to the callback and of blocks lost
+	uint64_t GetViewedCount() const { return mSubscription.GetViewedCount(); }
+	uint64_t GetLostCount() const { return mSubscription.GetLostCount(); }
+
+	// Whether callback threw, which ended the thread
+	bool HasFailed() const { return mFailed.load(); }
+
+	// Message of exception thrown by callback
+	std::string GetError() const;
+
+private:
+
+	// Loop of thread
+	void Run();
+
+	// Members
+	SampleSubscription mSubscription;
+	BlockCallback mCallback;
+	std::atomic<bool> mRunning{ true };
+	std::atomic<bool> mFailed{ false };
+	mutable std::mutex mMutex;
+	std::string mError; // guarded by mutex
+	std::thread mThread;
+};
+
+#endif // SAMPLE_SUBSCRIBER_H_
@@ -0,0 +1,283 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "SpatialFilter.h"
+#include "MemoryBounds.h"
+#include "SIMD.h"
+
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+// Defines
+const unsigned int spatialFilterSampleTile = 64; // samples processed per tile of outputs, keeping the tile's weights in L1
+const long long spatialFilterWatchInMiliseconds = 1000; // interval of checking files for changes
+
+// Time of last modification of file, zero if it does not exist
+static long long GetModificationTime(const std::string& rFilepath)
+{
+	struct stat info;
+	if (stat(rFilepath.c_str(), &info) != 0)
+	{
+		return 0;
+	}
+	return (long long)info.st_mtime;
+}
+
+std::shared_ptr<const SpatialFilterMatrix> LoadSpatialFilterMatrix(const std::string& rFilepath, const DeviceDescriptor& rDevice)
+{
+	std::ifstream file(rFilepath);
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Could not open spatial filter: " + rFilepath);
+	}
+
+	// Read label and weights of each output channel
+	std::vector<std::string> labels;
+	std::vector<float> weights;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream stream(line);
+		std::string label;
+		if (!(stream >> label) || label[0] == '#')
+		{
+			continue;
+		}
+		float weight = 0.f;
+		unsigned int weightCount = 0;
+		while (stream >> weight)
+		{
+			weights.push_back(weight);
+			weightCount++;
+		}
+		if (weightCount != rDevice.channelCount)
+		{
+			throw std::runtime_error("Spatial filter " + rFilepath + " has " + std::to_string(weightCount) + " weights for " + label + ", "
+				+ rDevice.name + " has " + std::to_string(rDevice.channelCount) + " channels");
+		}
+		labels.push_back(label);
+	}
+	if (labels.empty())
+	{
+		throw std::runtime_error("Spatial filter has no output channels: " + rFilepath);
+	}
+
+	// Transpose, so the weights of one input channel for all outputs are next to each other
+	std::shared_ptr<SpatialFilterMatrix> spMatrix = std::make_shared<SpatialFilterMatrix>();
+	spMatrix->labels = labels;
+	spMatrix->inputCount = rDevice.channelCount;
+	spMatrix->outputCount = (unsigned int)labels.size();
+	spMatrix->paddedOutputCount = (spMatrix->outputCount + simdWidth - 1) / simdWidth * simdWidth;
+	spMatrix->transposed.assign((size_t)spMatrix->inputCount * spMatrix->paddedOutputCount, 0.f);
+	for (unsigned int outputIdx = 0; outputIdx < spMatrix->outputCount; outputIdx++)
+	{
+		for (unsigned int inputIdx = 0; inputIdx < spMatrix->inputCount; inputIdx++)
+		{
+			spMatrix->transposed[(size_t)inputIdx * spMatrix->paddedOutputCount + outputIdx] = weights[(size_t)outputIdx * spMatrix->inputCount + inputIdx];
+		}
+	}
+	return spMatrix;
+}
+
+// Multiply samples with matrix, tile by tile. Outputs are processed in groups of SIMD width,
+// for which the input channels are accumulated in a register. Fixed input count lets the
+// compiler unroll the loop over input channels, zero takes the count of the matrix
+template<unsigned int FixedInputCount>
+static void SpatialFilterKernel(const SpatialFilterMatrix& rMatrix, const float* pInput, float* pOutput, unsigned int sampleCount)
+{
+	const unsigned int inputCount = FixedInputCount > 0 ? FixedInputCount : rMatrix.inputCount;
+	const unsigned int outputCount = rMatrix.outputCount;
+	const unsigned int paddedOutputCount = rMatrix.paddedOutputCount;
+	const float* pWeights = rMatrix.transposed.data();
+	float lastGroup[simdWidth];
+
+	for (unsigned int tileStart = 0; tileStart < sampleCount; tileStart += spatialFilterSampleTile)
+	{
+		unsigned int tileEnd = std::min(tileStart + spatialFilterSampleTile, sampleCount);
+		for (unsigned int outputIdx = 0; outputIdx < paddedOutputCount; outputIdx += simdWidth)
+		{
+			// Last group is written through buffer when it is not complete
+			bool partial = outputIdx + simdWidth > outputCount;
+			for (unsigned int sampleIdx = tileStart; sampleIdx < tileEnd; sampleIdx++)
+			{
+				const float* pSample = pInput + (size_t)sampleIdx * inputCount;
+				float* pTarget = partial ? lastGroup : pOutput + (size_t)sampleIdx * outputCount + outputIdx;
+#ifdef EMOTIVLSL_SSE
+				__m128 accumulator = _mm_setzero_ps();
+				for (unsigned int inputIdx = 0; inputIdx < inputCount; inputIdx++)
+				{
+					accumulator = _mm_add_ps(accumulator, _mm_mul_ps(_mm_set1_ps(pSample[inputIdx]), _mm_loadu_ps(pWeights + (size_t)inputIdx * paddedOutputCount + outputIdx)));
+				}
+				_mm_storeu_ps(pTarget, accumulator);
+#else
+				float accumulator = 0.f;
+				for (unsigned int inputIdx = 0; inputIdx < inputCount; inputIdx++)
+				{
+					accumulator += pSample[inputIdx] * pWeights[(size_t)inputIdx * paddedOutputCount + outputIdx];
+				}
+				*pTarget = accumulator;
+#endif
+				if (partial)
+				{
+					for (unsigned int i = 0; outputIdx + i < outputCount; i++)
+					{
+						pOutput[(size_t)sampleIdx * outputCount + outputIdx + i] = lastGroup[i];
+					}
+				}
+			}
+		}
+	}
+}
+
+void ApplySpatialFilter(const SpatialFilterMatrix& rMatrix, const SampleBlock& rInput, SampleBlock& rOutput)
+{
+	unsigned int sampleCount = rInput.SampleCount();
+	rOutput.Resize(rMatrix.outputCount, sampleCount);
+	rOutput.timestamps = rInput.timestamps;
+	if (sampleCount == 0)
+	{
+		return;
+	}
+
+	// Specialized for channel counts of the device profiles
+	switch (rMatrix.inputCount)
+	{
+	case EpocProfile::channelCount:
+		SpatialFilterKernel<EpocProfile::channelCount>(rMatrix, rInput.values.data(), rOutput.values.data(), sampleCount);
+		break;
+	case InsightProfile::channelCount:
+		SpatialFilterKernel<InsightProfile::channelCount>(rMatrix, rInput.values.data(), rOutput.values.data(), sampleCount);
+		break;
+	default:
+		SpatialFilterKernel<0>(rMatrix, rInput.values.data(), rOutput.values.data(), sampleCount);
+		break;
+	}
+}
+
+SpatialFilter::SpatialFilter(const std::string& rName, const std::string& rFilepath, const DeviceDescriptor& rDevice, const Config& rConfig) :
+	mName(rName),
+	mFilepath(rFilepath),
+	mrDevice(rDevice)
+{
+	// Load matrix
+	mModificationTime = GetModificationTime(mFilepath);
+	mspMatrix = LoadSpatialFilterMatrix(mFilepath, mrDevice);
+
+	// Stream information, channels are labelled as in the file
+	lsl::stream_info streamInfo("EmotivLSL_EEG_" + mName, "EEG", mspMatrix->outputCount, mrDevice.sampleRate, lsl::cf_float32, "source_id");
+	streamInfo.desc().append_child_value("manufacturer", "Emotiv");
+	streamInfo.desc().append_child_value("model", mrDevice.name);
+	lsl::xml_element channels = streamInfo.desc().append_child("channels");
+	for (const auto& rLabel : mspMatrix->labels)
+	{
+		channels.append_child("channel")
+			.append_child_value("label", rLabel)
+			.append_child_value("unit", mrDevice.unit)
+			.append_child_value("type", "EEG");
+	}
+	streamInfo.desc().append_child("spatial_filter")
+		.append_child_value("file", mFilepath);
+	mupOutlet = CreateOutlet(streamInfo, rConfig);
+	std::cout << "Spatial filter " << mName << " with " << mspMatrix->outputCount << " channels loaded from " << mFilepath << std::endl;
+}
+
+void SpatialFilter::Publish(const SampleBlock& rBlock)
+{
+	if (!mGate.IsOpen())
+	{
+		return;
+	}
+
+	// Matrix of the moment, a reload does not affect the running multiplication
+	std::shared_ptr<const SpatialFilterMatrix> spMatrix = std::atomic_load(&mspMatrix);
+	ApplySpatialFilter(*spMatrix, rBlock, mOutput);
+	mupOutlet->push_chunk_multiplexed(mOutput.values, mOutput.timestamps);
+}
+
+bool SpatialFilter::ReloadIfChanged()
+{
+	long long modificationTime = GetModificationTime(mFilepath);
+	if (modificationTime == 0 || modificationTime == mModificationTime)
+	{
+		return false;
+	}
+	mModificationTime = modificationTime;
+
+	// Keep old matrix when new one cannot be used
+	try
+	{
+		std::shared_ptr<const SpatialFilterMatrix> spMatrix = LoadSpatialFilterMatrix(mFilepath, mrDevice);
+		if (spMatrix->outputCount != std::atomic_load(&mspMatrix)->outputCount)
+		{
+			std::cout << "Spatial filter " << mName << " keeps its matrix, channel count of outlet cannot change" << std::endl;
+			return false;
+		}
+		std::atomic_store(&mspMatrix, spMatrix);
+	}
+	catch (const std::runtime_error& e)
+	{
+		std::cout << "Spatial filter " << mName << " keeps its matrix: " << e.what() << std::endl;
+		return false;
+	}
+	std::cout << "Spatial filter " << mName << " reloaded" << std::endl;
+	return true;
+}
+
+SpatialFilterWatcher::SpatialFilterWatcher(const std::vector<SpatialFilter*>& rFilters) : mFilters(rFilters)
+{
+	mThread = std::thread(&SpatialFilterWatcher::Run, this);
+}
+
+SpatialFilterWatcher::~SpatialFilterWatcher()
+{
+	mRunning = false;
+	if (mThread.joinable())
+	{
+		mThread.join();
+	}
+}
+
+void SpatialFilterWatcher::Run()
+{
+	// Sleep in small steps, so stopping does not wait for a whole interval
+	const long long stepInMiliseconds = 50;
+	long long waitedInMiliseconds = 0;
+	while (mRunning.load())
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(stepInMiliseconds));
+		waitedInMiliseconds += stepInMiliseconds;
+		if (waitedInMiliseconds < spatialFilterWatchInMiliseconds)
+		{
+			continue;
+		}
+		waitedInMiliseconds = 0;
+		for (SpatialFilter* pFilter : mFilters)
+		{
+			pFilter->ReloadIfChanged();
+		}
+	}
+}
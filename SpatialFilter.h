@@ -0,0 +1,122 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Linear spatial filters, like bipolar montages, Laplacians or CSP and PCA
+// projections, applied to every EEG block and published on their own outlet.
+// A filter is a matrix loaded from a text file, one line per output channel
+// holding its label followed by one weight per EEG channel of the device:
+//
+//   # bipolar montage
+//   F3-C3 0 0 1 0 0 0 -1 0 0 0 0 0 0 0
+//
+// Files are watched and reloaded on change by a separate thread. The new
+// matrix replaces the old one atomically, so publishing never waits for a
+// reload and always sees a complete matrix.
+
+#ifndef SPATIAL_FILTER_H_
+#define SPATIAL_FILTER_H_
+
+#include "lsl_cpp.h"
+
+#include "Config.h"
+#include "ConsumerGate.h"
+#include "DeviceProfile.h"
+#include "SampleBlock.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Projection matrix, stored transposed and padded for the kernel
+struct SpatialFilterMatrix
+{
+	std::vector<std::string> labels; // one per output channel
+	unsigned int inputCount = 0;
+	unsigned int outputCount = 0;
+	unsigned int paddedOutputCount = 0; // output count rounded up to SIMD width
+	std::vector<float> transposed; // input count rows of padded output count weights
+};
+
+// Load matrix from file for device. Throws runtime error if file is not readable or malformed
+std::shared_ptr<const SpatialFilterMatrix> LoadSpatialFilterMatrix(const std::string& rFilepath, const DeviceDescriptor& rDevice);
+
+// Apply matrix to every sample of input block, output block is replaced
+void ApplySpatialFilter(const SpatialFilterMatrix& rMatrix, const SampleBlock& rInput, SampleBlock& rOutput);
+
+class SpatialFilter
+{
+public:
+
+	// Constructor, loads matrix and creates outlet named after filter as configured
+	SpatialFilter(const std::string& rName, const std::string& rFilepath, const DeviceDescriptor& rDevice, const Config& rConfig);
+
+	// Check outlet for consumers. Returns whether it has some
+	bool UpdateConsumers(double now) { return mGate.Update(*mupOutlet, now); }
+
+	// Whether outlet had consumers at last check
+	bool IsOpen() const { return mGate.IsOpen(); }
+
+	// Filter block and push result, if outlet has consumers
+	void Publish(const SampleBlock& rBlock);
+
+	// Reload matrix if its file has changed. Matrices with other output count than
+	// the outlet are rejected. Returns whether matrix has been replaced
+	bool ReloadIfChanged();
+
+private:
+
+	// Members
+	std::string mName;
+	std::string mFilepath;
+	const DeviceDescriptor& mrDevice;
+	std::shared_ptr<const SpatialFilterMatrix> mspMatrix; // accessed atomically
+	long long mModificationTime = 0;
+	std::unique_ptr<lsl::stream_outlet> mupOutlet;
+	ConsumerGate mGate;
+	SampleBlock mOutput;
+};
+
+// Thread checking files of spatial filters for changes
+class SpatialFilterWatcher
+{
+public:
+
+	// Constructor, starts thread watching filters
+	SpatialFilterWatcher(const std::vector<SpatialFilter*>& rFilters);
+
+	// Destructor, stops thread
+	~SpatialFilterWatcher();
+
+private:
+
+	// Loop of thread
+	void Run();
+
+	// Members
+	std::vector<SpatialFilter*> mFilters;
+	std::atomic<bool> mRunning{ true };
+	std::thread mThread;
+};
+
+#endif // SPATIAL_FILTER_H_
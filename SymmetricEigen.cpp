@@ -0,0 +1,101 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "SymmetricEigen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+void SymmetricEigen(const std::vector<double>& rMatrix, unsigned int size, unsigned int sweepCount,
+	std::vector<double>& rEigenvalues, std::vector<double>& rEigenvectors)
+{
+	// Work on copy, eigenvectors start as identity
+	std::vector<double> a(rMatrix);
+	std::vector<double> v((size_t)size * size, 0.0);
+	for (unsigned int i = 0; i < size; i++)
+	{
+		v[(size_t)i * size + i] = 1.0;
+	}
+
+	// Rotate every off-diagonal element to zero, sweep after sweep
+	for (unsigned int sweep = 0; sweep < sweepCount; sweep++)
+	{
+		for (unsigned int p = 0; p + 1 < size; p++)
+		{
+			for (unsigned int q = p + 1; q < size; q++)
+			{
+				double apq = a[(size_t)p * size + q];
+				if (apq == 0.0)
+				{
+					continue;
+				}
+
+				// Rotation angle, smaller of both solutions for stability
+				double app = a[(size_t)p * size + p];
+				double aqq = a[(size_t)q * size + q];
+				double theta = (aqq - app) / (2.0 * apq);
+				double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+				double c = 1.0 / std::sqrt(t * t + 1.0);
+				double s = t * c;
+
+				// Apply rotation to rows and columns p and q
+				for (unsigned int k = 0; k < size; k++)
+				{
+					double akp = a[(size_t)k * size + p];
+					double akq = a[(size_t)k * size + q];
+					a[(size_t)k * size + p] = c * akp - s * akq;
+					a[(size_t)k * size + q] = s * akp + c * akq;
+				}
+				for (unsigned int k = 0; k < size; k++)
+				{
+					double apk = a[(size_t)p * size + k];
+					double aqk = a[(size_t)q * size + k];
+					a[(size_t)p * size + k] = c * apk - s * aqk;
+					a[(size_t)q * size + k] = s * apk + c * aqk;
+				}
+				for (unsigned int k = 0; k < size; k++)
+				{
+					double vkp = v[(size_t)k * size + p];
+					double vkq = v[(size_t)k * size + q];
+					v[(size_t)k * size + p] = c * vkp - s * vkq;
+					v[(size_t)k * size + q] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+
+	// Sort by eigenvalue
+	std::vector<unsigned int> order(size);
+	std::iota(order.begin(), order.end(), 0u);
+	std::sort(order.begin(), order.end(), [&a, size](unsigned int i, unsigned int j) { return a[(size_t)i * size + i] < a[(size_t)j * size + j]; });
+	rEigenvalues.resize(size);
+	rEigenvectors.resize((size_t)size * size);
+	for (unsigned int col = 0; col < size; col++)
+	{
+		rEigenvalues[col] = a[(size_t)order[col] * size + order[col]];
+		for (unsigned int row = 0; row < size; row++)
+		{
+			rEigenvectors[(size_t)row * size + col] = v[(size_t)row * size + order[col]];
+		}
+	}
+}
@@ -0,0 +1,38 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Eigendecomposition of small symmetric matrices by cyclic Jacobi rotations.
+// The count of sweeps is fixed, so run time does not depend on the data,
+// which is what a stage with a latency budget needs. For the channel counts
+// of the supported devices a handful of sweeps converges to float precision.
+
+#ifndef SYMMETRIC_EIGEN_H_
+#define SYMMETRIC_EIGEN_H_
+
+#include <vector>
+
+// Decompose symmetric matrix of size x size, stored row by row. Eigenvalues are sorted
+// ascending, eigenvectors are the columns of the row by row stored output matrix
+void SymmetricEigen(const std::vector<double>& rMatrix, unsigned int size, unsigned int sweepCount,
+	std::vector<double>& rEigenvalues, std::vector<double>& rEigenvectors);
+
+#endif // SYMMETRIC_EIGEN_H_
@@ -0,0 +1,145 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "Watchdog.h"
+#include "MemoryBounds.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Defines
+const long long watchdogCheckInMiliseconds = 20; // interval of checking stages
+
+// Labels of stages as used in alarms
+const char* watchdogStageLabels[WATCHDOG_STAGE_COUNT] =
+{
+	"ACQUISITION",
+	"EVENT_PUMP",
+	"DATA_UPDATE",
+	"EEG_SAMPLES",
+	"PUBLISHING"
+};
+
+Watchdog::Watchdog(double timeout, const Config& rConfig) : mTimeout(timeout), mConfig(rConfig)
+{
+	for (int i = 0; i < WATCHDOG_STAGE_COUNT; i++)
+	{
+		mLastBeats[i] = 0.0;
+		mTimeouts[i] = 0.0;
+		mStalled[i] = false;
+		mStallStarts[i] = 0.0;
+	}
+
+	// Thread is not needed when disabled
+	if (IsEnabled())
+	{
+		mThread = std::thread(&Watchdog::Run, this);
+	}
+}
+
+Watchdog::~Watchdog()
+{
+	mRunning = false;
+	if (mThread.joinable())
+	{
+		mThread.join();
+	}
+}
+
+void Watchdog::Arm(WatchdogStage stage, double now)
+{
+	Arm(stage, now, mTimeout);
+}
+
+void Watchdog::Arm(WatchdogStage stage, double now, double timeout)
+{
+	// Beat is stored first, so the thread never sees the timeout with a beat from before
+	if (IsEnabled())
+	{
+		mLastBeats[stage] = now;
+		mTimeouts[stage] = timeout;
+	}
+}
+
+void Watchdog::Beat(WatchdogStage stage, double now)
+{
+	if (IsEnabled())
+	{
+		mLastBeats[stage] = now;
+	}
+}
+
+void Watchdog::Disarm(WatchdogStage stage, double now)
+{
+	if (IsEnabled())
+	{
+		mLastBeats[stage] = now;
+		mTimeouts[stage] = 0.0;
+	}
+}
+
+void Watchdog::Run()
+{
+	// Outlet is created here, so creating it does not delay startup
+	lsl::stream_info streamInfo("EmotivLSL_Alarms", "Markers", 1, lsl::IRREGULAR_RATE, lsl::cf_string, "source_id");
+	streamInfo.desc().append_child_value("manufacturer", "Emotiv");
+	streamInfo.desc().append_child("channels")
+		.append_child("channel")
+			.append_child_value("label", "ALARM");
+	mupOutlet = CreateOutlet(streamInfo, mConfig);
+
+	while (mRunning.load())
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(watchdogCheckInMiliseconds));
+		for (int i = 0; i < WATCHDOG_STAGE_COUNT; i++)
+		{
+			// Timeout is read before beat, matching the order of arming
+			double timeout = mTimeouts[i].load();
+			double lastBeat = mLastBeats[i].load();
+			double now = lsl::local_clock();
+			bool stalled = timeout > 0.0 && now - lastBeat > timeout;
+			if (stalled && !mStalled[i])
+			{
+				mStalled[i] = true;
+				mStallStarts[i] = lastBeat;
+				mStallCount++;
+				PushAlarm("STALL", (WatchdogStage)i, now - lastBeat, now);
+			}
+			else if (!stalled && mStalled[i])
+			{
+				// Stage has beaten again or has been left
+				mStalled[i] = false;
+				PushAlarm("RECOVERED", (WatchdogStage)i, lastBeat - mStallStarts[i], now);
+			}
+		}
+	}
+}
+
+void Watchdog::PushAlarm(const char* pEvent, WatchdogStage stage, double duration, double now)
+{
+	// Alarm tells event, stage and seconds since its last beat, e.g. "STALL EEG_SAMPLES 0.320"
+	char alarm[64];
+	std::snprintf(alarm, sizeof(alarm), "%s %s %.3f", pEvent, watchdogStageLabels[stage], duration);
+	std::string sample(alarm);
+	mupOutlet->push_sample(&sample, now);
+}
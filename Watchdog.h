@@ -0,0 +1,98 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Watchdog on a thread of its own, noticing when acquisition stalls. Stages
+// beat while they make progress, or are armed when entering a call that may
+// block and disarmed when leaving it. When an armed stage has not beaten for
+// longer than its timeout, an alarm is pushed on the EmotivLSL_Alarms marker
+// stream, and another one once the stage continues, with the stall duration.
+
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+
+#include "lsl_cpp.h"
+
+#include "Config.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+// Watched stages
+enum WatchdogStage
+{
+	WATCHDOG_ACQUISITION, // iterations of main loop
+	WATCHDOG_EVENT_PUMP, // call of IEE_EngineGetNextEvent
+	WATCHDOG_DATA_UPDATE, // calls of IEE_DataUpdateHandle and IEE_MotionDataUpdateHandle
+	WATCHDOG_EEG_SAMPLES, // arrival of EEG samples while headset is added
+	WATCHDOG_PUBLISHING, // iterations of publishing thread
+	WATCHDOG_STAGE_COUNT
+};
+
+class Watchdog
+{
+public:
+
+	// Constructor with default timeout in seconds and configuration of outlet. Zero disables the watchdog, so all calls do nothing
+	Watchdog(double timeout, const Config& rConfig);
+
+	// Destructor, stops thread
+	~Watchdog();
+
+	// Expect beats of stage from now on, with default timeout or a timeout of its own
+	void Arm(WatchdogStage stage, double now);
+	void Arm(WatchdogStage stage, double now, double timeout);
+
+	// Tell that stage makes progress
+	void Beat(WatchdogStage stage, double now);
+
+	// Stop expecting beats of stage, e.g. when leaving a call
+	void Disarm(WatchdogStage stage, double now);
+
+	// Count of stalls so far
+	unsigned long long GetStallCount() const { return mStallCount.load(); }
+
+	// Getter
+	bool IsEnabled() const { return mTimeout > 0.0; }
+
+private:
+
+	// Loop of thread
+	void Run();
+
+	// Push alarm about stage
+	void PushAlarm(const char* pEvent, WatchdogStage stage, double duration, double now);
+
+	// Members
+	double mTimeout;
+	Config mConfig; // limits of outlet, read by thread
+	std::atomic<double> mLastBeats[WATCHDOG_STAGE_COUNT];
+	std::atomic<double> mTimeouts[WATCHDOG_STAGE_COUNT]; // zero while disarmed
+	bool mStalled[WATCHDOG_STAGE_COUNT]; // only accessed by thread
+	double mStallStarts[WATCHDOG_STAGE_COUNT]; // only accessed by thread
+	std::atomic<unsigned long long> mStallCount{ 0 };
+	std::unique_ptr<lsl::stream_outlet> mupOutlet; // created by thread
+	std::atomic<bool> mRunning{ true };
+	std::thread mThread;
+};
+
+#endif // WATCHDOG_H_
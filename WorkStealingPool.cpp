@@ -0,0 +1,153 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+
+// Index of the worker the current thread is and its pool, none for other threads
+static thread_local const WorkStealingPool* tpWorkerPool = nullptr;
+static thread_local unsigned int tWorkerIdx = 0;
+
+WorkStealingPool::WorkStealingPool(unsigned int threadCount)
+{
+	threadCount = std::max(threadCount, 1u);
+	for (unsigned int workerIdx = 0; workerIdx < threadCount; workerIdx++)
+	{
+		mQueues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue));
+	}
+	for (unsigned int workerIdx = 0; workerIdx < threadCount; workerIdx++)
+	{
+		mThreads.push_back(std::thread(&WorkStealingPool::Run, this, workerIdx));
+	}
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mSleepMutex);
+		mRunning = false;
+	}
+	mWakeup.notify_all();
+	for (auto& rThread : mThreads)
+	{
+		rThread.join();
+	}
+}
+
+void WorkStealingPool::Submit(Task task)
+{
+	// Workers keep their follow-up tasks, others take turns over the queues
+	unsigned int queueIdx = (tpWorkerPool == this)
+		? tWorkerIdx
+		: mNextQueue.fetch_add(1, std::memory_order_relaxed) % (unsigned int)mQueues.size();
+	{
+		std::lock_guard<std::mutex> lock(mQueues[queueIdx]->mutex);
+		mQueues[queueIdx]->tasks.push_back(std::move(task));
+	}
+
+	// Counter is changed under the sleep mutex, so no worker misses the wakeup
+	{
+		std::lock_guard<std::mutex> lock(mSleepMutex);
+		mQueuedTaskCount++;
+	}
+	mWakeup.notify_one();
+}
+
+void WorkStealingPool::Run(unsigned int workerIdx)
+{
+	tpWorkerPool = this;
+	tWorkerIdx = workerIdx;
+
+	// Keep going until stopped and all queues are drained
+	Task task;
+	while (true)
+	{
+		if (TakeTask(workerIdx, task))
+		{
+			mQueuedTaskCount--;
+			task();
+			task = nullptr;
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(mSleepMutex);
+		if (mQueuedTaskCount.load() > 0)
+		{
+			// Task is being taken by another worker right now
+			lock.unlock();
+			std::this_thread::yield();
+			continue;
+		}
+		if (!mRunning.load())
+		{
+			break;
+		}
+		mWakeup.wait(lock, [this]() { return mQueuedTaskCount.load() > 0 || !mRunning.load(); });
+	}
+}
+
+bool WorkStealingPool::TakeTask(unsigned int workerIdx, Task& rTask)
+{
+	// Newest task of own queue
+	{
+		WorkerQueue& rQueue = *mQueues[workerIdx];
+		std::lock_guard<std::mutex> lock(rQueue.mutex);
+		if (!rQueue.tasks.empty())
+		{
+			rTask = std::move(rQueue.tasks.back());
+			rQueue.tasks.pop_back();
+			return true;
+		}
+	}
+
+	// Oldest task of other queues, starting with the next worker
+	unsigned int queueCount = (unsigned int)mQueues.size();
+	for (unsigned int offset = 1; offset < queueCount; offset++)
+	{
+		WorkerQueue& rQueue = *mQueues[(workerIdx + offset) % queueCount];
+		std::lock_guard<std::mutex> lock(rQueue.mutex);
+		if (!rQueue.tasks.empty())
+		{
+			rTask = std::move(rQueue.tasks.front());
+			rQueue.tasks.pop_front();
+			mStolenTaskCount.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+	return false;
+}
+
+std::shared_ptr<WorkStealingPool> GetSharedWorkStealingPool(unsigned int threadCount)
+{
+	static std::mutex sharedMutex;
+	static std::weak_ptr<WorkStealingPool> wpShared;
+
+	// Pool lives as long as somebody uses it
+	std::lock_guard<std::mutex> lock(sharedMutex);
+	std::shared_ptr<WorkStealingPool> spPool = wpShared.lock();
+	if (!spPool)
+	{
+		spPool = std::make_shared<WorkStealingPool>(threadCount);
+		wpShared = spPool;
+	}
+	return spPool;
+}
@@ -0,0 +1,92 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Pool of worker threads executing small tasks. Every worker has its own
+// queue. Tasks submitted by a worker go to its own queue and are taken from
+// the back, so follow-up work stays on the thread that has its input in
+// cache. Idle workers steal from the front of the other queues. Tasks
+// submitted from outside the pool are spread over the queues in turn.
+
+#ifndef WORK_STEALING_POOL_H_
+#define WORK_STEALING_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool
+{
+public:
+
+	typedef std::function<void()> Task;
+
+	// Constructor, starts count of worker threads, at least one
+	WorkStealingPool(unsigned int threadCount);
+
+	// Destructor, runs remaining tasks and stops threads
+	~WorkStealingPool();
+
+	// Queue task for execution on any worker
+	void Submit(Task task);
+
+	// Count of worker threads
+	unsigned int GetThreadCount() const { return (unsigned int)mThreads.size(); }
+
+	// Count of tasks taken from the queue of another worker
+	unsigned long long GetStolenTaskCount() const { return mStolenTaskCount.load(std::memory_order_relaxed); }
+
+private:
+
+	// Queue of one worker, locked on its own so workers rarely contend
+	struct WorkerQueue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	// Loop of worker thread
+	void Run(unsigned int workerIdx);
+
+	// Take task from back of own queue or steal from front of another. Returns false when all are empty
+	bool TakeTask(unsigned int workerIdx, Task& rTask);
+
+	// Members
+	std::vector<std::unique_ptr<WorkerQueue> > mQueues;
+	std::vector<std::thread> mThreads;
+	std::atomic<unsigned int> mNextQueue{ 0 };
+	std::atomic<long long> mQueuedTaskCount{ 0 }; // may briefly be negative, as a task can be taken before it is counted
+	std::atomic<unsigned long long> mStolenTaskCount{ 0 };
+	std::atomic<bool> mRunning{ true };
+	std::mutex mSleepMutex;
+	std::condition_variable mWakeup;
+};
+
+// Pool shared by all acquisitions of the process, so headsets streamed by several of them
+// do not each bring their own threads. Created with count of threads on first request
+std::shared_ptr<WorkStealingPool> GetSharedWorkStealingPool(unsigned int threadCount);
+
+#endif // WORK_STEALING_POOL_H_
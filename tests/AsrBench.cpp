@@ -0,0 +1,156 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Cost of artifact subspace reconstruction per block at 256 Hz. The cleaner
+// is calibrated on a minute of synthetic clean EEG, correlated noise with an
+// alpha rhythm, then processes EEG with blinks and muscle bursts in blocks as
+// acquisition hands them over, with the default latency budget. Mean,
+// percentiles and maximum of the processing time per block are reported with
+// the blocks over budget, for blocks of one iteration and of a backlog.
+
+#include "Asr.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+// Defines
+const unsigned int channelCount = 14;
+const double sampleRate = 256.0;
+const double calibrationDuration = 60.0; // default of asrCalibration
+const double cutoff = 5.0; // default of asrCutoff
+const double windowDuration = 0.5; // default of asrWindow
+const double latencyBudget = 0.005; // default of asrLatencyBudget
+const unsigned int blockSampleCounts[] = { 13, 64 }; // 50 ms of acquisition, backlog after a stall
+const double defaultSecondsPerRun = 120.0;
+
+// Synthetic EEG, with blinks on frontal channels and muscle bursts on temporal ones when requested
+class SyntheticEEG
+{
+public:
+
+	// Constructor, mixes independent sources into correlated channels
+	SyntheticEEG() : mGenerator(42), mMixing(channelCount * channelCount)
+	{
+		std::normal_distribution<double> normal(0.0, 1.0);
+		for (double& rWeight : mMixing) { rWeight = normal(mGenerator); }
+	}
+
+	// Fill block with next samples
+	void Fill(SampleBlock& rBlock, unsigned int sampleCount, bool artifacts)
+	{
+		std::normal_distribution<double> normal(0.0, 1.0);
+		rBlock.Resize(channelCount, sampleCount);
+		double sources[channelCount];
+		for (unsigned int sampleIdx = 0; sampleIdx < sampleCount; sampleIdx++, mSampleIdx++)
+		{
+			double time = mSampleIdx / sampleRate;
+			for (double& rSource : sources) { rSource = 5.0 * normal(mGenerator); }
+			sources[0] += 20.0 * std::sin(2.0 * 3.14159265358979 * 10.0 * time); // alpha
+			bool blink = artifacts && std::fmod(time, 4.0) < 0.3;
+			bool burst = artifacts && std::fmod(time, 7.0) > 6.0;
+			for (unsigned int channelIdx = 0; channelIdx < channelCount; channelIdx++)
+			{
+				double value = 4200.0;
+				for (unsigned int sourceIdx = 0; sourceIdx < channelCount; sourceIdx++)
+				{
+					value += mMixing[channelIdx * channelCount + sourceIdx] * sources[sourceIdx];
+				}
+				if (blink && (channelIdx == 0 || channelIdx == 13)) // AF3 and AF4
+				{
+					value += 300.0 * std::sin(3.14159265358979 * std::fmod(time, 4.0) / 0.3);
+				}
+				if (burst && (channelIdx == 4 || channelIdx == 9)) // T7 and T8
+				{
+					value += 80.0 * normal(mGenerator);
+				}
+				rBlock.values[(size_t)sampleIdx * channelCount + channelIdx] = (float)value;
+			}
+			rBlock.timestamps[sampleIdx] = time;
+		}
+	}
+
+private:
+
+	// Members
+	std::mt19937 mGenerator;
+	std::vector<double> mMixing;
+	unsigned long long mSampleIdx = 0;
+};
+
+// Value at fraction of sorted durations
+static double Percentile(const std::vector<double>& rSorted, double fraction)
+{
+	return rSorted[std::min(rSorted.size() - 1, (size_t)(fraction * rSorted.size()))];
+}
+
+int main(int argc, char** argv)
+{
+	double secondsPerRun = argc > 1 ? std::atof(argv[1]) : defaultSecondsPerRun;
+	std::cout << std::setw(8) << "samples" << std::setw(10) << "blocks" << std::setw(12) << "mean us" << std::setw(12) << "p99 us"
+		<< std::setw(12) << "max us" << std::setw(12) << "budget us" << std::setw(10) << "over" << std::setw(10) << "removed" << std::endl; // removed components per block
+	for (unsigned int sampleCount : blockSampleCounts)
+	{
+		// Calibration on clean data
+		ArtifactSubspaceReconstruction asr(channelCount, sampleRate, calibrationDuration, cutoff, windowDuration, latencyBudget);
+		SyntheticEEG eeg;
+		SampleBlock input;
+		SampleBlock output;
+		while (!asr.IsCalibrated())
+		{
+			eeg.Fill(input, sampleCount, false);
+			asr.Process(input, output);
+		}
+
+		// Cleaning of data with artifacts, timed per block
+		unsigned int blockCount = (unsigned int)(secondsPerRun * sampleRate / sampleCount);
+		std::vector<double> durations;
+		durations.reserve(blockCount);
+		unsigned long long removedCount = 0;
+		for (unsigned int blockIdx = 0; blockIdx < blockCount; blockIdx++)
+		{
+			eeg.Fill(input, sampleCount, true);
+			double startTime = SecondsSinceStart();
+			asr.Process(input, output);
+			durations.push_back(SecondsSinceStart() - startTime);
+			removedCount += asr.GetRemovedComponentCount();
+		}
+
+		// Budget is met when blocks stay within it, the cleaner counts those that did not
+		std::sort(durations.begin(), durations.end());
+		double sum = 0.0;
+		for (double duration : durations) { sum += duration; }
+		std::cout << std::setw(8) << sampleCount
+			<< std::setw(10) << blockCount
+			<< std::setw(12) << std::fixed << std::setprecision(1) << sum / durations.size() * 1e6
+			<< std::setw(12) << Percentile(durations, 0.99) * 1e6
+			<< std::setw(12) << durations.back() * 1e6
+			<< std::setw(12) << latencyBudget * 1e6
+			<< std::setw(10) << asr.GetBudgetOverrunCount()
+			<< std::setw(10) << std::setprecision(2) << (double)removedCount / blockCount << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,104 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Test of tuning the size of the SDK buffers. Updates are fed as acquisition
+// does every 50 ms at 256 Hz: the buffer must double at once when an update
+// nearly fills it, stay within its bounds, and halve only after its fill
+// stayed low for the whole period. With the defaults of acquisition it never
+// becomes smaller than the initial size.
+
+#include "BufferTuner.h"
+#include "TestCheck.h"
+
+// Defines
+const double sampleRate = 256.0;
+const double iteration = 0.05; // seconds between updates
+const unsigned int samplesPerIteration = 13;
+
+// Feed updates of regular iterations for duration. Returns count of size changes
+static unsigned int Feed(BufferTuner& rTuner, double& rTime, double duration)
+{
+	unsigned int changeCount = 0;
+	for (double end = rTime + duration; rTime < end; rTime += iteration)
+	{
+		changeCount += rTuner.Add(samplesPerIteration, sampleRate, rTime) ? 1 : 0;
+	}
+	return changeCount;
+}
+
+int main()
+{
+	// Initial size is clamped to bounds
+	CHECK(BufferTuner(0.1, 0.5, 8.0).GetSize() == 0.5);
+	CHECK(BufferTuner(20.0, 0.5, 8.0).GetSize() == 8.0);
+	CHECK(BufferTuner(1.0, 2.0, 1.0).GetMaxSize() == 2.0);
+
+	// Defaults of acquisition keep the initial size under regular iterations
+	double time = 0.0;
+	BufferTuner defaults(2.0, 2.0, 8.0);
+	CHECK(Feed(defaults, time, 300.0) == 0);
+	CHECK(defaults.GetSize() == 2.0);
+	CHECK(defaults.GetNearOverflowCount() == 0);
+	CHECK(defaults.GetPeakFill() > 0.0 && defaults.GetPeakFill() < 0.03);
+
+	// Iteration late by almost the whole buffer doubles it at once, up to the maximum
+	CHECK(defaults.Add((unsigned int)(1.9 * sampleRate), sampleRate, time));
+	CHECK(defaults.GetSize() == 4.0);
+	CHECK(defaults.GetNearOverflowCount() == 1);
+	CHECK(defaults.GetPeakFill() >= 0.9);
+	defaults.ResetPeakFill();
+	CHECK(defaults.GetPeakFill() == 0.0);
+	CHECK(defaults.Add((unsigned int)(3.8 * sampleRate), sampleRate, time));
+	CHECK(!defaults.Add((unsigned int)(7.9 * sampleRate), sampleRate, time));
+	CHECK(defaults.GetSize() == 8.0);
+	CHECK(defaults.GetNearOverflowCount() == 3);
+
+	// Low fill halves it once per period, back to the initial size and no further
+	CHECK(Feed(defaults, time, 29.0) == 0);
+	CHECK(defaults.GetSize() == 8.0);
+	CHECK(Feed(defaults, time, 2.0) == 1);
+	CHECK(defaults.GetSize() == 4.0);
+	CHECK(Feed(defaults, time, 300.0) == 1);
+	CHECK(defaults.GetSize() == 2.0);
+
+	// A late iteration restarts the period, so shrinking waits for a whole period of low fill
+	BufferTuner tuner(1.0, 0.5, 8.0);
+	time = 0.0;
+	tuner.Add(samplesPerIteration, sampleRate, time);
+	CHECK(Feed(tuner, time, 20.0) == 0);
+	CHECK(tuner.Add((unsigned int)(0.95 * sampleRate), sampleRate, time));
+	CHECK(tuner.GetSize() == 2.0);
+	CHECK(Feed(tuner, time, 29.0) == 0);
+	CHECK(Feed(tuner, time, 2.0) == 1);
+	CHECK(tuner.GetSize() == 1.0);
+
+	// Fill of a quarter or more keeps the size, lower bound is kept when configured lower
+	time += 1.0;
+	for (double end = time + 60.0; time < end; time += iteration)
+	{
+		CHECK(!tuner.Add((unsigned int)(0.3 * sampleRate), sampleRate, time));
+	}
+	CHECK(tuner.GetSize() == 1.0);
+	CHECK(Feed(tuner, time, 120.0) == 1);
+	CHECK(tuner.GetSize() == 0.5);
+	return TestResult("BufferTunerTest");
+}
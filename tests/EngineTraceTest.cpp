@@ -0,0 +1,265 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Test of recording and replaying EmoEngine calls. A scripted backend stands
+// in for the EmoEngine and is driven through the recorder like acquisition
+// drives it, then the trace is replayed through the same calls. Everything
+// observed must be the same in both runs, EmoStates must only be read from
+// the backend and recorded when asked for, and traces of another version must
+// be rejected.
+
+#include "EngineTrace.h"
+#include "IedkErrorCode.h"
+#include "TestCheck.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+// Defines
+const std::string traceFilepath = "EngineTraceTest.trace";
+const unsigned int iterationCount = 20;
+const unsigned int statesPerIteration = 3;
+const unsigned int headsetEpocMode = 1;
+const unsigned int headsetEegRate = 256;
+const unsigned int motionSampleRate = 64;
+const double untracedValue = -1.0; // logged instead of NaN, which never compares equal
+
+// Backend answering with values derived from the iteration
+class ScriptedEngine : public EngineBackend
+{
+public:
+
+	// Implementation of interface
+	virtual int Connect() { return EDK_OK; }
+	virtual void Disconnect() {}
+	virtual void SetBufferSize(float) {}
+	virtual int GetNextEvent(EngineEvent& rEvent)
+	{
+		// First event adds user, then states follow until the queue of the iteration is empty
+		unsigned int eventCount = statesPerIteration + (mIteration == 0 ? 1 : 0);
+		if (mEventIdx >= eventCount)
+		{
+			mEventIdx = 0;
+			mIteration++;
+			return EDK_NO_EVENT;
+		}
+		rEvent.type = (mIteration == 0 && mEventIdx == 0) ? IEE_UserAdded : IEE_EmoStateUpdated;
+		rEvent.userID = 7;
+		mState = mIteration * statesPerIteration + mEventIdx;
+		mEventIdx++;
+		return EDK_OK;
+	}
+	virtual int ReadEmoState(EmoStateSnapshot& rState)
+	{
+		mReadCount++;
+		rState.timeFromStart = (float)mState * 0.125f;
+		rState.blink = mState % 2 == 0;
+		rState.winkLeft = mState % 3 == 0;
+		rState.winkRight = mState % 5 == 0;
+		rState.upperFaceAction = FE_SURPRISE;
+		rState.upperFacePower = (float)(mState % 8) / 8.f;
+		rState.lowerFaceAction = FE_SMILE;
+		rState.lowerFacePower = (float)(mState % 4) / 4.f;
+		for (int metricIdx = 0; metricIdx < PERFORMANCE_METRIC_COUNT; metricIdx++)
+		{
+			rState.performanceMetrics[metricIdx][0] = mState + metricIdx * 0.1;
+			rState.performanceMetrics[metricIdx][1] = -metricIdx;
+			rState.performanceMetrics[metricIdx][2] = metricIdx + 1.0;
+		}
+		return EDK_OK;
+	}
+	virtual void EnableAcquisition(unsigned int) {}
+	virtual int GetHeadsetSettings(unsigned int, unsigned int& rEpocMode, unsigned int& rEegRate)
+	{
+		rEpocMode = headsetEpocMode;
+		rEegRate = headsetEegRate;
+		return EDK_OK;
+	}
+	virtual int GetMotionSampleRate(unsigned int, unsigned int& rSampleRate)
+	{
+		rSampleRate = motionSampleRate;
+		return EDK_OK;
+	}
+	virtual unsigned int CreateStream(EngineStreamType) { return mStreamCount++; }
+	virtual void UpdateStream(unsigned int, unsigned int) {}
+	virtual unsigned int GetSampleCount(unsigned int stream) { return 4 + (mIteration + stream) % 3; }
+	virtual void GetEEG(unsigned int stream, const IEE_DataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount)
+	{
+		Fill(stream, pChannels, channelCount, ppChannels, sampleCount);
+	}
+	virtual void GetMotion(unsigned int stream, const IEE_MotionDataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount)
+	{
+		Fill(stream, pChannels, channelCount, ppChannels, sampleCount);
+	}
+
+	// Count of EmoStates read
+	unsigned int GetReadCount() const { return mReadCount; }
+
+private:
+
+	// Values exactly representable as 32 bit floats
+	template<typename Channel>
+	void Fill(unsigned int stream, const Channel* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount)
+	{
+		for (unsigned int channelIdx = 0; channelIdx < channelCount; channelIdx++)
+		{
+			for (unsigned int sampleIdx = 0; sampleIdx < sampleCount; sampleIdx++)
+			{
+				ppChannels[channelIdx][sampleIdx] = mIteration * 1000.0 + stream * 100.0 + (int)pChannels[channelIdx] + sampleIdx * 0.25;
+			}
+		}
+	}
+
+	// Members
+	unsigned int mIteration = 0;
+	unsigned int mEventIdx = 0;
+	unsigned int mState = 0;
+	unsigned int mReadCount = 0;
+	unsigned int mStreamCount = 0;
+};
+
+// Call backend like acquisition does and log everything observed. Only every other EmoState is read
+static std::vector<double> Drive(EngineBackend& rEngine)
+{
+	std::vector<double> log;
+	log.push_back(rEngine.Connect());
+	rEngine.SetBufferSize(2.f);
+	unsigned int eegStream = rEngine.CreateStream(ENGINE_STREAM_EEG);
+	unsigned int motionStream = rEngine.CreateStream(ENGINE_STREAM_MOTION);
+	const IEE_DataChannel_t eegChannels[] = { IED_AF3, IED_O1, IED_COUNTER, IED_AF4 }; // counter is not traced
+	const IEE_MotionDataChannel_t motionChannels[] = { IMD_GYROX, IMD_MAGZ };
+	unsigned int stateIdx = 0;
+	for (unsigned int iteration = 0; iteration < iterationCount; iteration++)
+	{
+		// Events, with some of the EmoStates read
+		EngineEvent event;
+		int error = 0;
+		while ((error = rEngine.GetNextEvent(event)) == EDK_OK)
+		{
+			log.push_back(event.type);
+			log.push_back(event.userID);
+			if (event.type == IEE_UserAdded)
+			{
+				unsigned int epocMode = 0, eegRate = 0, sampleRate = 0;
+				log.push_back(rEngine.GetHeadsetSettings(event.userID, epocMode, eegRate));
+				log.push_back(epocMode);
+				log.push_back(eegRate);
+				log.push_back(rEngine.GetMotionSampleRate(event.userID, sampleRate));
+				log.push_back(sampleRate);
+			}
+			else if (event.type == IEE_EmoStateUpdated && stateIdx++ % 2 == 0)
+			{
+				EmoStateSnapshot state;
+				log.push_back(rEngine.ReadEmoState(state));
+				log.push_back(state.timeFromStart);
+				log.push_back(state.blink + 2 * state.winkLeft + 4 * state.winkRight);
+				log.push_back(state.upperFaceAction);
+				log.push_back(state.upperFacePower);
+				log.push_back(state.lowerFaceAction);
+				log.push_back(state.lowerFacePower);
+				for (int metricIdx = 0; metricIdx < PERFORMANCE_METRIC_COUNT; metricIdx++)
+				{
+					log.insert(log.end(), state.performanceMetrics[metricIdx], state.performanceMetrics[metricIdx] + 3);
+				}
+			}
+		}
+		log.push_back(error);
+
+		// Samples of both streams
+		for (unsigned int stream : { eegStream, motionStream })
+		{
+			rEngine.UpdateStream(stream, 7);
+			unsigned int sampleCount = rEngine.GetSampleCount(stream);
+			unsigned int channelCount = (stream == eegStream) ? 4 : 2;
+			std::vector<double> values((size_t)channelCount * sampleCount);
+			std::vector<double*> channelPointers(channelCount);
+			for (unsigned int channelIdx = 0; channelIdx < channelCount; channelIdx++)
+			{
+				channelPointers[channelIdx] = values.data() + (size_t)channelIdx * sampleCount;
+			}
+			if (stream == eegStream)
+			{
+				rEngine.GetEEG(stream, eegChannels, channelCount, channelPointers.data(), sampleCount);
+			}
+			else
+			{
+				rEngine.GetMotion(stream, motionChannels, channelCount, channelPointers.data(), sampleCount);
+			}
+			log.push_back(sampleCount);
+			for (double value : values)
+			{
+				log.push_back(std::isnan(value) ? untracedValue : value);
+			}
+		}
+	}
+	rEngine.Disconnect();
+	return log;
+}
+
+int main()
+{
+	// Record scripted backend
+	std::vector<double> recordedLog;
+	{
+		ScriptedEngine* pScripted = new ScriptedEngine();
+		TraceRecorder recorder(std::unique_ptr<EngineBackend>(pScripted), traceFilepath);
+		recordedLog = Drive(recorder);
+		CHECK(pScripted->GetReadCount() == (iterationCount * statesPerIteration + 1) / 2);
+	}
+
+	// Replay sees the same, including the untraced channel filled with NaN
+	{
+		TraceReplayer replayer(traceFilepath, false);
+		CHECK(!replayer.IsPaced());
+		std::vector<double> replayedLog = Drive(replayer);
+		CHECK(replayedLog.size() == recordedLog.size());
+		CHECK(replayedLog == recordedLog);
+		CHECK(replayer.IsFinished());
+
+		// EmoStates not read when recording are not in the trace
+		EmoStateSnapshot state;
+		CHECK(replayer.ReadEmoState(state) == EDK_UNKNOWN_ERROR);
+	}
+
+	// Trace of another version is rejected
+	{
+		std::fstream file(traceFilepath, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(8);
+		uint32_t version = 1;
+		file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+	}
+	bool rejected = false;
+	try
+	{
+		TraceReplayer replayer(traceFilepath, false);
+	}
+	catch (const std::runtime_error&)
+	{
+		rejected = true;
+	}
+	CHECK(rejected);
+	std::remove(traceFilepath.c_str());
+	return TestResult("EngineTraceTest");
+}
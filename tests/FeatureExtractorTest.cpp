@@ -0,0 +1,270 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Test of the feature extractor against features computed directly over the
+// window: band power from a DFT of the window, Hjorth parameters and channel
+// covariance from two passes over it. EEG with a large offset, sines and
+// noise is fed in blocks of varying size, so hops cross blocks. Every vector
+// must match, from the first one of a window that has just filled, with
+// differences still zero at its start, over the recomputations from the
+// window, which happen every sixteen windows, up to those after a reset in
+// the middle of a block.
+
+#include "FeatureExtractor.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// Defines
+const unsigned int channelCount = 3;
+const double sampleRate = 128.0;
+const unsigned int windowLength = 64; // bins of 2 Hz
+const unsigned int hop = 3;
+const unsigned int resyncLength = 16 * windowLength; // samples between recomputations
+const unsigned int sampleCount = 2 * resyncLength + 500; // crosses two recomputations
+const unsigned int resetSample = 2 * resyncLength + 100; // in the middle of a block
+const unsigned int blockSizes[] = { 1, 7, 13, 64, 5 }; // taken in turn
+const double powerFloor = 1e-12; // as added by the extractor
+const double pi = 3.14159265358979323846;
+
+// Features of the newest window of samples since reset, computed directly
+static std::vector<double> DirectFeatures(const std::vector<float>& rSamples, size_t first, size_t end, const std::vector<FrequencyBand>& rBands)
+{
+	// Differences restart with the samples
+	size_t count = end - first;
+	std::vector<double> firstDifferences(count * channelCount, 0.0);
+	std::vector<double> secondDifferences(count * channelCount, 0.0);
+	for (size_t sampleIdx = 1; sampleIdx < count; sampleIdx++)
+	{
+		for (unsigned int channelIdx = 0; channelIdx < channelCount; channelIdx++)
+		{
+			size_t idx = sampleIdx * channelCount + channelIdx;
+			firstDifferences[idx] = (double)rSamples[(first + sampleIdx) * channelCount + channelIdx] - (double)rSamples[(first + sampleIdx - 1) * channelCount + channelIdx];
+			if (sampleIdx > 1)
+			{
+				secondDifferences[idx] = firstDifferences[idx] - firstDifferences[idx - channelCount];
+			}
+		}
+	}
+
+	// Mean and variance of a channel over window
+	size_t windowStart = count - windowLength;
+	auto variance = [windowStart](const std::vector<double>& rValues, unsigned int channelIdx, double& rMean)
+	{
+		rMean = 0.0;
+		for (size_t sampleIdx = windowStart; sampleIdx < windowStart + windowLength; sampleIdx++) { rMean += rValues[sampleIdx * channelCount + channelIdx]; }
+		rMean /= windowLength;
+		double squares = 0.0;
+		for (size_t sampleIdx = windowStart; sampleIdx < windowStart + windowLength; sampleIdx++)
+		{
+			double deviation = rValues[sampleIdx * channelCount + channelIdx] - rMean;
+			squares += deviation * deviation;
+		}
+		return squares / windowLength;
+	};
+	std::vector<double> values(rSamples.begin() + first * channelCount, rSamples.begin() + end * channelCount);
+
+	std::vector<double> features;
+	std::vector<double> means(channelCount);
+	for (unsigned int channelIdx = 0; channelIdx < channelCount; channelIdx++)
+	{
+		// Band power as mean square amplitude of the bins of a DFT over the window
+		double binWidth = sampleRate / windowLength;
+		for (const FrequencyBand& rBand : rBands)
+		{
+			double power = 0.0;
+			for (unsigned int bin = 1; bin <= windowLength / 2; bin++)
+			{
+				if (bin * binWidth < rBand.low || bin * binWidth >= rBand.high)
+				{
+					continue;
+				}
+				double real = 0.0;
+				double imaginary = 0.0;
+				for (unsigned int n = 0; n < windowLength; n++)
+				{
+					double value = values[(windowStart + n) * channelCount + channelIdx];
+					real += value * std::cos(2.0 * pi * bin * n / windowLength);
+					imaginary -= value * std::sin(2.0 * pi * bin * n / windowLength);
+				}
+				power += real * real + imaginary * imaginary;
+			}
+			features.push_back(std::log(power * 2.0 / ((double)windowLength * windowLength) + powerFloor));
+		}
+
+		// Hjorth parameters
+		double meanFirst = 0.0;
+		double meanSecond = 0.0;
+		double activity = variance(values, channelIdx, means[channelIdx]);
+		double varianceFirst = variance(firstDifferences, channelIdx, meanFirst);
+		double varianceSecond = variance(secondDifferences, channelIdx, meanSecond);
+		double mobility = std::sqrt(varianceFirst / activity);
+		features.push_back(activity);
+		features.push_back(mobility);
+		features.push_back(std::sqrt(varianceSecond / varianceFirst) / mobility);
+	}
+
+	// Covariance of channel pairs
+	for (unsigned int i = 0; i < channelCount; i++)
+	{
+		for (unsigned int j = i; j < channelCount; j++)
+		{
+			double products = 0.0;
+			for (size_t sampleIdx = windowStart; sampleIdx < count; sampleIdx++)
+			{
+				products += (values[sampleIdx * channelCount + i] - means[i]) * (values[sampleIdx * channelCount + j] - means[j]);
+			}
+			features.push_back(products / (windowLength - 1.0));
+		}
+	}
+	return features;
+}
+
+// Whether extracted features match direct ones. Log powers are compared absolutely, covariances relative to the largest variance
+static bool Matches(const float* pFeatures, const std::vector<double>& rExpected, unsigned int bandCount)
+{
+	bool matches = true;
+	size_t featureIdx = 0;
+	double maxActivity = 0.0;
+	for (unsigned int channelIdx = 0; channelIdx < channelCount; channelIdx++)
+	{
+		for (unsigned int bandIdx = 0; bandIdx < bandCount; bandIdx++, featureIdx++)
+		{
+			matches &= std::abs(pFeatures[featureIdx] - rExpected[featureIdx]) <= 1e-4;
+		}
+		maxActivity = std::max(maxActivity, rExpected[featureIdx]);
+		for (unsigned int hjorthIdx = 0; hjorthIdx < 3; hjorthIdx++, featureIdx++)
+		{
+			matches &= std::abs(pFeatures[featureIdx] - rExpected[featureIdx]) <= 1e-4 * std::max(1.0, std::abs(rExpected[featureIdx]));
+		}
+	}
+	for (; featureIdx < rExpected.size(); featureIdx++)
+	{
+		matches &= std::abs(pFeatures[featureIdx] - rExpected[featureIdx]) <= 1e-4 * maxActivity;
+	}
+	return matches;
+}
+
+int main()
+{
+	std::vector<FrequencyBand> bands = ParseFrequencyBands({ "4-8", "8-13", "13-30", "30-45" });
+	FeatureExtractor extractor(channelCount, sampleRate, windowLength, hop, bands);
+	CHECK(extractor.GetFeatureCount() == channelCount * (bands.size() + 3) + channelCount * (channelCount + 1) / 2);
+
+	// Offset like Emotiv EEG, sines of their own per channel and noise
+	std::mt19937 generator(7);
+	std::normal_distribution<double> noise(0.0, 2.0);
+	std::vector<float> samples((size_t)sampleCount * channelCount);
+	for (unsigned int sampleIdx = 0; sampleIdx < sampleCount; sampleIdx++)
+	{
+		double time = sampleIdx / sampleRate;
+		for (unsigned int channelIdx = 0; channelIdx < channelCount; channelIdx++)
+		{
+			samples[(size_t)sampleIdx * channelCount + channelIdx] = (float)(4200.0 + 30.0 * std::sin(2.0 * pi * 10.0 * time + channelIdx)
+				+ (10.0 + 5.0 * channelIdx) * std::sin(2.0 * pi * (6.0 + 9.0 * channelIdx) * time) + noise(generator));
+		}
+	}
+
+	// Feed blocks stamped with sample index, resetting where the block is split
+	unsigned int vectorCount = 0;
+	unsigned int mismatchCount = 0;
+	unsigned int resyncedVectorCount = 0;
+	bool stampsValid = true;
+	size_t resetFirst = 0;
+	unsigned int sinceVector = 0;
+	SampleBlock input;
+	SampleBlock output;
+	for (unsigned int first = 0, blockIdx = 0; first < sampleCount; blockIdx++)
+	{
+		unsigned int end = std::min(first + blockSizes[blockIdx % (sizeof(blockSizes) / sizeof(blockSizes[0]))], sampleCount);
+		if (first < resetSample && end > resetSample)
+		{
+			end = resetSample;
+		}
+		if (first == resetSample)
+		{
+			extractor.Reset();
+			resetFirst = first;
+			sinceVector = 0;
+		}
+		input.Resize(channelCount, end - first);
+		std::copy(samples.begin() + (size_t)first * channelCount, samples.begin() + (size_t)end * channelCount, input.values.begin());
+		for (unsigned int sampleIdx = first; sampleIdx < end; sampleIdx++)
+		{
+			input.timestamps[sampleIdx - first] = sampleIdx;
+		}
+		extractor.Process(input, output);
+
+		// Vectors once window is full and every hop from then on
+		unsigned int expectedCount = 0;
+		for (unsigned int sampleIdx = first; sampleIdx < end; sampleIdx++)
+		{
+			sinceVector++;
+			if (sampleIdx + 1 - resetFirst >= windowLength && sinceVector >= hop)
+			{
+				sinceVector = 0;
+				if (expectedCount < output.SampleCount())
+				{
+					stampsValid &= output.timestamps[expectedCount] == sampleIdx;
+				}
+				expectedCount++;
+			}
+		}
+		CHECK(output.SampleCount() == expectedCount);
+		for (unsigned int vectorIdx = 0; vectorIdx < std::min(expectedCount, output.SampleCount()); vectorIdx++)
+		{
+			size_t newest = (size_t)output.timestamps[vectorIdx];
+			std::vector<double> expected = DirectFeatures(samples, resetFirst, newest + 1, bands);
+			if (!Matches(&output.values[(size_t)vectorIdx * extractor.GetFeatureCount()], expected, (unsigned int)bands.size()))
+			{
+				mismatchCount++;
+			}
+			vectorCount++;
+			if (newest + 1 - resetFirst > resyncLength)
+			{
+				resyncedVectorCount++;
+			}
+		}
+		first = end;
+	}
+	CHECK(stampsValid);
+	CHECK(mismatchCount == 0);
+	CHECK(resyncedVectorCount > 0);
+	std::cout << "Compared " << vectorCount << " feature vectors, " << resyncedVectorCount << " after a recomputation, " << mismatchCount << " mismatched" << std::endl;
+
+	// Bands without bin are rejected
+	bool rejected = false;
+	try
+	{
+		FeatureExtractor(channelCount, sampleRate, windowLength, hop, ParseFrequencyBands({ "9-10" }));
+	}
+	catch (const std::runtime_error&)
+	{
+		rejected = true;
+	}
+	CHECK(rejected);
+	return TestResult("FeatureExtractorTest");
+}
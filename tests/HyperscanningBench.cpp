@@ -0,0 +1,200 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Cost of aggregating EEG of several headsets for hyperscanning. Headsets
+// are simulated once, each with its own clock drift, and their stream updates
+// are recorded into a trace. The trace is then replayed as source of two to
+// eight headsets, fetched every iteration of acquisition, and the time spent
+// in each update of the aggregator is reported with the samples it had to
+// drop or fill with NaN. An inlet is opened on the aggregated stream, so the
+// aggregator does its work, but it is never read.
+
+#include "EngineTrace.h"
+#include "Hyperscanning.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+// Defines
+const std::string traceFilepath = "HyperscanningBench.trace";
+const unsigned int maxHeadsetCount = 8;
+const unsigned int headsetCounts[] = { 2, 4, 6, 8 };
+const long long iterationInMiliseconds = 50; // like acquisition
+const double defaultSecondsPerRun = 5.0;
+const double maxLatency = 0.5; // default of hyperscanningMaxLatency
+const unsigned int clockWindowSize = 1200; // default clockWindow of 60 s in iterations
+const double driftStepInPpm = 40.0; // clocks of headsets differ by this much from one to the next
+
+// Headsets streaming EEG in simulated time, each with its own clock drift
+class SimulatedHeadsets : public EngineBackend
+{
+public:
+
+	// Constructor with device whose sample rate is simulated
+	SimulatedHeadsets(const DeviceDescriptor& rDevice) : mrDevice(rDevice) {}
+
+	// Advance simulated time
+	void SetTime(double time) { mTime = time; }
+
+	// Implementation of interface, streams deliver what their clock produced since last update
+	virtual int Connect() { return EDK_OK; }
+	virtual void Disconnect() {}
+	virtual void SetBufferSize(float) {}
+	virtual int GetNextEvent(EngineEvent&) { return EDK_NO_EVENT; }
+	virtual int ReadEmoState(EmoStateSnapshot&) { return EDK_UNKNOWN_ERROR; }
+	virtual void EnableAcquisition(unsigned int) {}
+	virtual int GetHeadsetSettings(unsigned int, unsigned int&, unsigned int&) { return EDK_UNKNOWN_ERROR; }
+	virtual int GetMotionSampleRate(unsigned int, unsigned int&) { return EDK_UNKNOWN_ERROR; }
+	virtual unsigned int CreateStream(EngineStreamType)
+	{
+		mProduced.push_back(0);
+		mSampleCounts.push_back(0);
+		return (unsigned int)mProduced.size() - 1;
+	}
+	virtual void UpdateStream(unsigned int stream, unsigned int)
+	{
+		double rate = mrDevice.sampleRate * (1.0 + ((double)stream - 0.5 * maxHeadsetCount) * driftStepInPpm * 1e-6);
+		unsigned long long produced = (unsigned long long)(mTime * rate);
+		mSampleCounts[stream] = (unsigned int)(produced - mProduced[stream]);
+		mProduced[stream] = produced;
+	}
+	virtual unsigned int GetSampleCount(unsigned int stream) { return mSampleCounts[stream]; }
+	virtual void GetEEG(unsigned int stream, const IEE_DataChannel_t* pChannels, unsigned int channelCount, double** ppChannels, unsigned int sampleCount)
+	{
+		// Sine of ten hertz, phase shifted per channel
+		unsigned long long first = mProduced[stream] - mSampleCounts[stream];
+		for (unsigned int channelIdx = 0; channelIdx < channelCount; channelIdx++)
+		{
+			for (unsigned int sampleIdx = 0; sampleIdx < sampleCount; sampleIdx++)
+			{
+				ppChannels[channelIdx][sampleIdx] = 4200.0 + 50.0 * std::sin(2.0 * 3.14159265358979 * 10.0 * (first + sampleIdx) / mrDevice.sampleRate + pChannels[channelIdx]);
+			}
+		}
+	}
+	virtual void GetMotion(unsigned int, const IEE_MotionDataChannel_t*, unsigned int, double**, unsigned int) {}
+
+private:
+
+	// Members
+	const DeviceDescriptor& mrDevice;
+	double mTime = 0.0;
+	std::vector<unsigned long long> mProduced;
+	std::vector<unsigned int> mSampleCounts;
+};
+
+// Record updates of all simulated headsets for every iteration of the given duration
+static void RecordTrace(const DeviceDescriptor& rDevice, double seconds)
+{
+	SimulatedHeadsets* pHeadsets = new SimulatedHeadsets(rDevice);
+	TraceRecorder recorder(std::unique_ptr<EngineBackend>(pHeadsets), traceFilepath);
+	for (unsigned int headsetIdx = 0; headsetIdx < maxHeadsetCount; headsetIdx++)
+	{
+		recorder.CreateStream(ENGINE_STREAM_EEG);
+	}
+	unsigned int iterationCount = (unsigned int)(seconds * 1000.0 / iterationInMiliseconds);
+	for (unsigned int iterationIdx = 1; iterationIdx <= iterationCount; iterationIdx++)
+	{
+		pHeadsets->SetTime(iterationIdx * iterationInMiliseconds / 1000.0);
+		for (unsigned int headsetIdx = 0; headsetIdx < maxHeadsetCount; headsetIdx++)
+		{
+			recorder.UpdateStream(headsetIdx, headsetIdx);
+		}
+	}
+	recorder.Disconnect();
+}
+
+// Replay trace for count of headsets, paced like acquisition. Returns row of table with cost of updates
+static std::string Run(const DeviceDescriptor& rDevice, unsigned int headsetCount, double seconds)
+{
+	TraceReplayer replayer(traceFilepath, false);
+	HyperscanAggregator aggregator(replayer, rDevice, headsetCount, maxLatency, clockWindowSize, Config());
+	for (unsigned int userID = 0; userID < headsetCount; userID++)
+	{
+		aggregator.AddUser(userID, rDevice);
+	}
+
+	// Consumer that never reads
+	std::vector<lsl::stream_info> results = lsl::resolve_stream("name", "EmotivLSL_EEG_Hyperscanning", 1, 10.0);
+	if (results.empty())
+	{
+		return "Aggregated stream not found";
+	}
+	lsl::stream_inlet inlet(results[0]);
+	inlet.open_stream(10.0);
+
+	// Iterations at fixed times, as acquisition waits for its next one
+	std::vector<double> durations;
+	unsigned int iterationCount = (unsigned int)(seconds * 1000.0 / iterationInMiliseconds);
+	std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+	for (unsigned int iterationIdx = 0; iterationIdx < iterationCount; iterationIdx++)
+	{
+		next += std::chrono::milliseconds(iterationInMiliseconds);
+		std::this_thread::sleep_until(next);
+		double startTime = SecondsSinceStart();
+		aggregator.Update(lsl::local_clock());
+		durations.push_back(SecondsSinceStart() - startTime);
+	}
+
+	// Skip first second, where the gate opens and clocks settle
+	durations.erase(durations.begin(), durations.begin() + std::min(durations.size(), (size_t)(1000 / iterationInMiliseconds)));
+	double sum = 0.0;
+	for (double duration : durations) { sum += duration; }
+	double mean = durations.empty() ? 0.0 : sum / durations.size();
+	double maximum = durations.empty() ? 0.0 : *std::max_element(durations.begin(), durations.end());
+	std::ostringstream row;
+	row << std::setw(8) << headsetCount
+		<< std::setw(14) << std::fixed << std::setprecision(1) << mean * 1e6
+		<< std::setw(14) << mean * 1e6 / headsetCount
+		<< std::setw(14) << maximum * 1e6
+		<< std::setw(12) << std::setprecision(3) << 100.0 * mean * 1000.0 / iterationInMiliseconds
+		<< std::setw(10) << aggregator.GetDroppedSampleCount()
+		<< std::setw(10) << aggregator.GetMissingSampleCount();
+	return row.str();
+}
+
+int main(int argc, char** argv)
+{
+	double secondsPerRun = argc > 1 ? std::atof(argv[1]) : defaultSecondsPerRun;
+	DeviceDescriptor device = MakeDeviceDescriptor<EpocPlus256Profile>();
+	RecordTrace(device, secondsPerRun);
+	std::vector<std::string> rows;
+	for (unsigned int headsetCount : headsetCounts)
+	{
+		rows.push_back(Run(device, headsetCount, secondsPerRun));
+	}
+	std::remove(traceFilepath.c_str());
+
+	// Table after what the runs printed
+	std::cout << std::setw(8) << "headsets" << std::setw(14) << "mean us" << std::setw(14) << "us/headset"
+		<< std::setw(14) << "max us" << std::setw(12) << "% of tick" << std::setw(10) << "dropped" << std::setw(10) << "missing" << std::endl;
+	for (const std::string& rRow : rows)
+	{
+		std::cout << rRow << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,95 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Test of loading and evaluating linear classifier models. Models are written
+// to temporary files, inconsistent ones must be rejected on loading.
+
+#include "LinearClassifier.h"
+#include "TestCheck.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+// Defines
+const std::string modelFilepath = "LinearClassifierTest.model";
+
+// Write model file and try to load it for count of features. Returns whether it was accepted
+static bool Load(const std::string& rModel, unsigned int featureCount, std::unique_ptr<LinearClassifier>& rupClassifier)
+{
+	{
+		std::ofstream file(modelFilepath);
+		file << rModel;
+	}
+	try
+	{
+		rupClassifier = std::unique_ptr<LinearClassifier>(new LinearClassifier(modelFilepath, featureCount));
+		return true;
+	}
+	catch (const std::runtime_error&)
+	{
+		return false;
+	}
+}
+
+int main()
+{
+	std::unique_ptr<LinearClassifier> upClassifier;
+
+	// Models without two classes to tell apart are rejected, even if rows and labels match
+	CHECK(!Load("classes ONLY\nweights 1 2\nbias 0\n", 2, upClassifier));
+	CHECK(!Load("weights 1 2\nbias 0\n", 2, upClassifier));
+
+	// Count of rows must match classes, or be a single one for two classes
+	CHECK(!Load("classes A B C\nweights 1 2\nbias 0\n", 2, upClassifier));
+	CHECK(!Load("classes A B\nweights 1 2\nweights 3 4\nbias 0\n", 2, upClassifier));
+	CHECK(!Load("classes A B\nweights 1 2 3\nbias 0\n", 2, upClassifier));
+
+	// Binary logistic model with normalization, probability of second class for zero score is one half
+	if (CHECK(Load("classes REST TASK\nmean 1 1\nscale 2 2\nweights 2 -2\nbias 0.5\n", 2, upClassifier)))
+	{
+		CHECK(upClassifier->GetClassCount() == 2);
+		float features[2] = { 3.f, 1.f }; // normalized to 1 and 0, score 2.5
+		float probabilities[3] = { 0.f, 0.f, -1.f }; // last one guards against writing past the classes
+		upClassifier->Predict(features, probabilities);
+		CHECK(std::fabs(probabilities[1] - 1.f / (1.f + std::exp(-2.5f))) < 1e-5f);
+		CHECK(std::fabs(probabilities[0] + probabilities[1] - 1.f) < 1e-5f);
+		CHECK(probabilities[2] == -1.f);
+	}
+
+	// Softmax over three classes sums to one and favours the highest score
+	if (CHECK(Load("classes A B C\nweights 1 0\nweights 0 1\nweights 0 0\nbias 0 0 0\n", 2, upClassifier)))
+	{
+		float features[2] = { 2.f, 0.f };
+		float probabilities[4] = { 0.f, 0.f, 0.f, -1.f };
+		upClassifier->Predict(features, probabilities);
+		CHECK(std::fabs(probabilities[0] + probabilities[1] + probabilities[2] - 1.f) < 1e-5f);
+		CHECK(probabilities[0] > probabilities[1] && std::fabs(probabilities[1] - probabilities[2]) < 1e-6f);
+		CHECK(probabilities[3] == -1.f);
+	}
+
+	std::remove(modelFilepath.c_str());
+	return TestResult("LinearClassifierTest");
+}
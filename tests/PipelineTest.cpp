@@ -0,0 +1,240 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Test of the pipeline of derived streams and the pool it runs on. A graph
+// with a stage feeding another, stages on both sources and one producing no
+// output for some blocks is run inline and on pools of one and three workers.
+// Every stage must see its blocks in order and only those it is fed, stages
+// must only run while their output is wanted and be reset after skipping
+// blocks. Inputs that are unknown or form a cycle are rejected. The pool on
+// its own must run every task, also those submitted by tasks. Latencies taken
+// per interval while workers add them must add up to all that were added.
+
+#include "Pipeline.h"
+#include "TestCheck.h"
+
+#include <stdexcept>
+#include <thread>
+
+// Defines
+const unsigned int blockCount = 200;
+const unsigned int queueCapacity = 256; // no block is dropped
+const unsigned int pausedFirst = 101; // blocks for which the dependent stage is not wanted
+const unsigned int pausedLast = 120;
+const unsigned int threadCounts[] = { 0, 1, 3 }; // zero runs stages on submitting thread
+const unsigned int taskCount = 10000;
+const unsigned int latencyCount = 100000; // per adding thread
+
+// Whether values increase from one to the next
+static bool Increasing(const std::vector<float>& rValues)
+{
+	for (size_t valueIdx = 1; valueIdx < rValues.size(); valueIdx++)
+	{
+		if (rValues[valueIdx] <= rValues[valueIdx - 1]) { return false; }
+	}
+	return true;
+}
+
+// Whether pipeline rejects graph with stage inputs
+static bool Rejects(const std::vector<std::pair<std::string, std::string> >& rStages)
+{
+	Pipeline pipeline(nullptr, 4);
+	for (const auto& rStage : rStages)
+	{
+		pipeline.AddStage(rStage.first, rStage.second, [](const SampleBlock&) -> const SampleBlock* { return nullptr; }, []() { return true; });
+	}
+	try
+	{
+		pipeline.Finalize();
+	}
+	catch (const std::runtime_error&)
+	{
+		return true;
+	}
+	return false;
+}
+
+// Run graph for all blocks on pool with count of threads
+static void RunGraph(unsigned int threadCount)
+{
+	std::shared_ptr<WorkStealingPool> spPool;
+	if (threadCount > 0)
+	{
+		spPool = std::make_shared<WorkStealingPool>(threadCount);
+	}
+
+	// Values seen by stages, only touched by their stage until drained
+	std::vector<float> seenScaled;
+	std::vector<float> seenDependent;
+	std::vector<float> seenRaw;
+	std::vector<float> seenMain;
+	unsigned int dependentResets = 0;
+	std::atomic<bool> dependentWanted{ true };
+	SampleBlock scaled;
+	{
+		Pipeline pipeline(spPool, queueCapacity);
+
+		// Dependent is added before its input, which is not wanted on its own and gives no output for every third block
+		pipeline.AddStage("dependent", "scaled", [&](const SampleBlock& rInput) -> const SampleBlock*
+		{
+			seenDependent.push_back(rInput.values[0]);
+			return nullptr;
+		}, [&]() { return dependentWanted.load(); }, [&]() { dependentResets++; });
+		pipeline.AddStage("scaled", pipelineSourceRaw, [&](const SampleBlock& rInput) -> const SampleBlock*
+		{
+			seenScaled.push_back(rInput.values[0]);
+			scaled = rInput;
+			scaled.values[0] *= 10.f;
+			std::this_thread::sleep_for(std::chrono::microseconds(100)); // stages of several blocks overlap on the pool
+			return ((unsigned int)rInput.values[0] % 3 == 0) ? nullptr : &scaled;
+		}, []() { return false; });
+		pipeline.AddStage("raw", pipelineSourceRaw, [&](const SampleBlock& rInput) -> const SampleBlock*
+		{
+			seenRaw.push_back(rInput.values[0]);
+			return nullptr;
+		}, []() { return true; });
+		pipeline.AddStage("main", pipelineSourceMain, [&](const SampleBlock& rInput) -> const SampleBlock*
+		{
+			seenMain.push_back(rInput.values[0]);
+			return nullptr;
+		}, []() { return true; });
+		pipeline.Finalize();
+		CHECK(pipeline.GetStageCount() == 4);
+
+		// Raw blocks carry their number, main ones its negative
+		SampleBlock raw;
+		SampleBlock main;
+		raw.Resize(1, 1);
+		main.Resize(1, 1);
+		for (unsigned int blockIdx = 1; blockIdx <= blockCount; blockIdx++)
+		{
+			raw.values[0] = (float)blockIdx;
+			main.values[0] = -(float)blockIdx;
+
+			// Whether output is wanted is asked when the block starts, so queued blocks are drained before it changes
+			bool wanted = blockIdx < pausedFirst || blockIdx > pausedLast;
+			if (wanted != dependentWanted.load())
+			{
+				pipeline.Drain();
+				dependentWanted = wanted;
+			}
+			CHECK(pipeline.Submit(raw, main));
+		}
+		pipeline.Drain();
+		CHECK(pipeline.GetDroppedBlockCount() == 0);
+		CHECK(pipeline.GetLatency().GetCount() == blockCount);
+		for (unsigned int stageIdx = 0; stageIdx < pipeline.GetStageCount(); stageIdx++)
+		{
+			CHECK(pipeline.GetStageTiming(stageIdx).GetCount() > 0);
+		}
+	}
+
+	// Sources are seen completely and in order
+	CHECK(seenRaw.size() == blockCount && Increasing(seenRaw));
+	CHECK(seenMain.size() == blockCount);
+	for (unsigned int blockIdx = 0; blockIdx < seenMain.size(); blockIdx++)
+	{
+		CHECK(seenMain[blockIdx] == -(float)(blockIdx + 1));
+	}
+
+	// Stage not wanted on its own runs exactly while its dependent is wanted
+	CHECK(seenScaled.size() == blockCount - (pausedLast - pausedFirst + 1) && Increasing(seenScaled));
+	for (float value : seenScaled)
+	{
+		CHECK(value < pausedFirst || value > pausedLast);
+	}
+
+	// Dependent sees output of its input only, in order, and is reset on its first block and after it was paused
+	CHECK(Increasing(seenDependent));
+	unsigned int expectedDependentCount = 0;
+	for (float value : seenScaled)
+	{
+		expectedDependentCount += ((unsigned int)value % 3 == 0) ? 0 : 1;
+	}
+	CHECK(seenDependent.size() == expectedDependentCount);
+	for (float value : seenDependent)
+	{
+		CHECK((unsigned int)value % 10 == 0 && ((unsigned int)value / 10) % 3 != 0);
+	}
+	CHECK(dependentResets == 2);
+	std::cout << "Pipeline with " << threadCount << " workers: " << seenDependent.size() << " blocks reached the dependent stage" << std::endl;
+}
+
+int main()
+{
+	for (unsigned int threadCount : threadCounts)
+	{
+		RunGraph(threadCount);
+	}
+
+	// Graphs that cannot be ordered
+	CHECK(Rejects({ { "first", "second" }, { "second", "first" } }));
+	CHECK(Rejects({ { "first", "unknown" } }));
+	CHECK(!Rejects({ { "first", pipelineSourceRaw }, { "second", "first" } }));
+
+	// Pool runs every task, also those submitted by tasks, before it is destroyed
+	std::atomic<unsigned int> runCount{ 0 };
+	{
+		WorkStealingPool pool(3);
+		CHECK(pool.GetThreadCount() == 3);
+		for (unsigned int taskIdx = 0; taskIdx < taskCount; taskIdx++)
+		{
+			pool.Submit([&pool, &runCount]()
+			{
+				runCount++;
+				pool.Submit([&runCount]() { runCount++; });
+			});
+		}
+	}
+	CHECK(runCount.load() == 2 * taskCount);
+	CHECK(WorkStealingPool(0).GetThreadCount() == 1);
+
+	// Intervals taken concurrently lose no latency and repeat none
+	LatencyMonitor monitor;
+	std::vector<std::thread> adders;
+	for (unsigned int threadIdx = 0; threadIdx < 3; threadIdx++)
+	{
+		adders.emplace_back([&monitor]()
+		{
+			for (unsigned int latencyIdx = 0; latencyIdx < latencyCount; latencyIdx++)
+			{
+				monitor.Add(1.0);
+			}
+		});
+	}
+	unsigned long long takenCount = 0;
+	bool maxValid = true;
+	for (unsigned int intervalIdx = 0; intervalIdx <= 1000; intervalIdx++)
+	{
+		if (intervalIdx == 1000)
+		{
+			for (std::thread& rAdder : adders) { rAdder.join(); }
+		}
+		LatencyInterval interval = monitor.TakeInterval();
+		takenCount += interval.count;
+		maxValid &= interval.max == 0.0 || interval.max == 1.0;
+	}
+	CHECK(takenCount == 3ull * latencyCount);
+	CHECK(maxValid);
+	CHECK(monitor.GetCount() == 0);
+	return TestResult("PipelineTest");
+}
@@ -0,0 +1,172 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Test of the polyphase resampler with sines of known frequency, from 128 Hz
+// down to 100 Hz and up to 250 Hz. Input arrives in blocks of varying size,
+// some of them too short for an output sample. Once the filter has settled,
+// every output sample must equal the sine at its timestamp, which only holds
+// when timestamps are corrected for the group delay. Amplitude from the mean
+// square and frequency from zero crossings must match the input, and output
+// samples must follow each other at the output rate across blocks.
+
+#include "PolyphaseResampler.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Defines
+const unsigned int channelCount = 5; // channels side by side and one on its own
+const unsigned int inputRate = 128;
+const unsigned int tapsPerPhase = 16; // default of resampleTapsPerPhase
+const double duration = 20.0; // seconds of input
+const double startTime = 1000.0; // timestamp of first input sample
+const double amplitude = 100.0;
+const double frequencies[channelCount] = { 3.0, 5.0, 10.0, 17.0, 23.0 }; // Hz, within passband of both rates
+const unsigned int blockSizes[] = { 13, 1, 0, 32, 7, 64, 2 }; // taken in turn
+const double tolerance = 0.001; // relative to amplitude
+
+// Sine of channel at time
+static double Sine(unsigned int channelIdx, double time)
+{
+	return amplitude * std::sin(2.0 * 3.14159265358979323846 * frequencies[channelIdx] * (time - startTime) + channelIdx);
+}
+
+// Resample sines in blocks to rate, checking output against the sines
+static void Run(unsigned int outputRate)
+{
+	unsigned int up = 0;
+	unsigned int down = 0;
+	ReduceRateFraction(inputRate, outputRate, up, down);
+	PolyphaseResampler resampler(channelCount, inputRate, up, down, tapsPerPhase);
+	CHECK(std::abs(resampler.GetOutputRate() - outputRate) < 1e-9);
+
+	// Output of all blocks after each other
+	std::vector<float> values;
+	std::vector<double> timestamps;
+	unsigned int inputCount = (unsigned int)(duration * inputRate);
+	SampleBlock input;
+	SampleBlock output;
+	for (unsigned int first = 0, blockIdx = 0; first < inputCount; blockIdx++)
+	{
+		unsigned int end = std::min(first + blockSizes[blockIdx % (sizeof(blockSizes) / sizeof(blockSizes[0]))], inputCount);
+		input.Resize(channelCount, end - first);
+		for (unsigned int sampleIdx = first; sampleIdx < end; sampleIdx++)
+		{
+			double time = startTime + (double)sampleIdx / inputRate;
+			input.timestamps[sampleIdx - first] = time;
+			for (unsigned int channelIdx = 0; channelIdx < channelCount; channelIdx++)
+			{
+				input.values[(size_t)(sampleIdx - first) * channelCount + channelIdx] = (float)Sine(channelIdx, time);
+			}
+		}
+		resampler.Process(input, output);
+		CHECK(output.channelCount == channelCount && output.values.size() == (size_t)output.SampleCount() * channelCount);
+		values.insert(values.end(), output.values.begin(), output.values.end());
+		timestamps.insert(timestamps.end(), output.timestamps.begin(), output.timestamps.end());
+		first = end;
+	}
+
+	// One output sample per output interval, the first one stamped before the first input by the group delay
+	unsigned int outputCount = (unsigned int)timestamps.size();
+	CHECK(outputCount == (unsigned int)std::ceil((double)inputCount * up / down));
+	CHECK(std::abs(timestamps[0] - (startTime - resampler.GetGroupDelay())) < 1e-9);
+	bool spacingValid = true;
+	for (unsigned int sampleIdx = 1; sampleIdx < outputCount; sampleIdx++)
+	{
+		spacingValid &= std::abs(timestamps[sampleIdx] - timestamps[sampleIdx - 1] - 1.0 / outputRate) < 1e-9;
+	}
+	CHECK(spacingValid);
+
+	// Settled once the filter is filled with input
+	double settledTime = startTime + (double)tapsPerPhase / inputRate;
+	unsigned int settledIdx = 0;
+	while (settledIdx < outputCount && timestamps[settledIdx] < settledTime) { settledIdx++; }
+	double maxError = 0.0;
+	for (unsigned int channelIdx = 0; channelIdx < channelCount; channelIdx++)
+	{
+		// Value at each timestamp
+		double squares = 0.0;
+		for (unsigned int sampleIdx = settledIdx; sampleIdx < outputCount; sampleIdx++)
+		{
+			double value = values[(size_t)sampleIdx * channelCount + channelIdx];
+			maxError = std::max(maxError, std::abs(value - Sine(channelIdx, timestamps[sampleIdx])));
+			squares += value * value;
+		}
+
+		// Amplitude from mean square, the last partial period hardly counts over the duration
+		double rms = std::sqrt(squares / (outputCount - settledIdx));
+		CHECK(std::abs(rms * std::sqrt(2.0) - amplitude) < tolerance * amplitude);
+
+		// Frequency from first and last upward zero crossing, interpolated between samples
+		double firstCrossing = 0.0;
+		double lastCrossing = 0.0;
+		unsigned int crossingCount = 0;
+		for (unsigned int sampleIdx = settledIdx + 1; sampleIdx < outputCount; sampleIdx++)
+		{
+			double previous = values[(size_t)(sampleIdx - 1) * channelCount + channelIdx];
+			double current = values[(size_t)sampleIdx * channelCount + channelIdx];
+			if (previous < 0.0 && current >= 0.0)
+			{
+				double crossing = timestamps[sampleIdx - 1] + (timestamps[sampleIdx] - timestamps[sampleIdx - 1]) * previous / (previous - current);
+				if (crossingCount == 0) { firstCrossing = crossing; }
+				lastCrossing = crossing;
+				crossingCount++;
+			}
+		}
+		double frequency = crossingCount > 1 ? (crossingCount - 1) / (lastCrossing - firstCrossing) : 0.0;
+		CHECK(std::abs(frequency - frequencies[channelIdx]) < 1e-3 * frequencies[channelIdx]);
+	}
+	CHECK(maxError < tolerance * amplitude);
+	std::cout << inputRate << " Hz to " << outputRate << " Hz: " << outputCount << " samples, group delay "
+		<< resampler.GetGroupDelay() * 1000.0 << " ms, maximal error " << maxError / amplitude * 100.0 << " % of amplitude" << std::endl;
+}
+
+int main()
+{
+	unsigned int up = 0;
+	unsigned int down = 0;
+	ReduceRateFraction(128, 250, up, down);
+	CHECK(up == 125 && down == 64);
+
+	// Down and up
+	Run(100);
+	Run(250);
+
+	// Reset starts over like a new resampler
+	PolyphaseResampler resampler(1, inputRate, 25, 32, tapsPerPhase);
+	SampleBlock input;
+	input.Resize(1, 40);
+	for (unsigned int sampleIdx = 0; sampleIdx < 40; sampleIdx++)
+	{
+		input.values[sampleIdx] = (float)Sine(0, startTime + (double)sampleIdx / inputRate);
+		input.timestamps[sampleIdx] = startTime + (double)sampleIdx / inputRate;
+	}
+	SampleBlock first;
+	SampleBlock again;
+	resampler.Process(input, first);
+	resampler.Reset();
+	resampler.Process(input, again);
+	CHECK(first.values == again.values && first.timestamps == again.timestamps);
+	return TestResult("PolyphaseResamplerTest");
+}
@@ -0,0 +1,173 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Test of the ring policies and outlet memory bounds with a stalled inlet.
+// The main EEG stream gets an inlet which is opened but never read. For each
+// policy, publishing first stalls (no publisher) until the ring is full, then
+// resumes and an hour of 256 Hz EEG is pushed as fast as the policy allows.
+// Counters of dropped and blocked blocks must match what happened, every
+// block must be accounted for, and the memory of the process must stay far
+// below what the queue of the stalled inlet would take without bound.
+
+#include "EEGChain.h"
+#include "EEGPublisher.h"
+#include "MemoryBounds.h"
+#include "SampleRing.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <thread>
+
+// Defines
+const size_t slotCount = 16;
+const unsigned int samplesPerBlock = 16;
+const double floodSeconds = 3600.0; // seconds of EEG pushed while the inlet stalls
+const double outletMemoryLimitInMiB = 1.0;
+const size_t maxResidentGrowthInMiB = 32; // the stalled inlet would queue over a hundred MiB without bound
+const std::chrono::milliseconds blockWait(20);
+
+// Fill reserved block with samples stamped from index
+static void FillBlock(SampleBlock& rBlock, const DeviceDescriptor& rDevice, unsigned long long blockIdx)
+{
+	rBlock.Resize(rDevice.channelCount, samplesPerBlock);
+	for (size_t valueIdx = 0; valueIdx < rBlock.values.size(); valueIdx++)
+	{
+		rBlock.values[valueIdx] = (float)(valueIdx % 100);
+	}
+	rBlock.StampBackwards((double)(blockIdx + 1) * samplesPerBlock / rDevice.sampleRate, rDevice.sampleRate);
+}
+
+// Stall publishing until ring is full, then resume it and flood the outlets with the policy
+static void RunPolicy(RingPolicy policy, std::shared_ptr<EEGChain> spChain)
+{
+	const DeviceDescriptor& rDevice = spChain->GetDevice();
+	SampleRing ring(slotCount, rDevice.channelCount, samplesPerBlock);
+	unsigned long long committedCount = 0;
+
+	// Without publisher, nobody reads the ring
+	for (size_t slotIdx = 0; slotIdx < ring.GetCapacity(); slotIdx++)
+	{
+		CHECK(ring.Reserve(1) == 1);
+		FillBlock(ring.Reserved(0), rDevice, committedCount++);
+		ring.Commit(1);
+	}
+	if (policy == RING_BLOCK)
+	{
+		// Producer waits for the stalled consumer, then it is refused
+		double startTime = SecondsSinceStart();
+		CHECK(ring.Reserve(1, blockWait) == 0);
+		CHECK(SecondsSinceStart() - startTime >= 0.9 * std::chrono::duration<double>(blockWait).count());
+		CHECK(ring.GetBlocks() == 1);
+	}
+	else
+	{
+		CHECK(ring.Reserve(1) == 0);
+		CHECK(ring.GetBlocks() == 0);
+	}
+	CHECK(ring.GetOverflows() == 1);
+	CHECK(ring.GetDroppedOldest() == 0);
+
+	// Publishing resumes. Dropping oldest blocks makes room for the newer half at once
+	EEGPublisher publisher(ring, policy);
+	publisher.SetChain(spChain);
+	while (ring.GetFill() > 0)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	CHECK(ring.GetDroppedOldest() == (policy == RING_DROP_OLDEST ? ring.GetCapacity() / 2 : 0));
+
+	// Hour of EEG as fast as the ring takes it, the inlet still does not read
+	unsigned long long attemptCount = (unsigned long long)(floodSeconds * rDevice.sampleRate / samplesPerBlock);
+	for (unsigned long long attemptIdx = 0; attemptIdx < attemptCount; attemptIdx++)
+	{
+		size_t reserved = (policy == RING_BLOCK) ? ring.Reserve(1, blockWait) : ring.Reserve(1);
+		if (reserved == 1)
+		{
+			FillBlock(ring.Reserved(0), rDevice, committedCount++);
+			ring.Commit(1);
+		}
+		else
+		{
+			// Like the acquisition loop, try again on next tick
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+	publisher.Stop();
+
+	// Every block is refused, dropped or published. Blocks taken before the chain was set are not counted as published
+	unsigned long long publishedCount = publisher.GetPublishedBlockCount();
+	unsigned long long droppedCount = ring.GetDroppedOldest();
+	CHECK(ring.GetFill() == 0);
+	CHECK(committedCount + ring.GetOverflows() == ring.GetCapacity() + 1 + attemptCount);
+	CHECK(publishedCount + droppedCount <= committedCount);
+	CHECK(committedCount - (publishedCount + droppedCount) <= ring.GetCapacity());
+	if (policy == RING_BLOCK)
+	{
+		CHECK(droppedCount == 0);
+		CHECK(ring.GetBlocks() > 1);
+	}
+	else
+	{
+		CHECK(droppedCount > ring.GetCapacity() / 2);
+	}
+	std::cout << (policy == RING_BLOCK ? "block" : "dropOldest") << ": committed " << committedCount << ", published " << publishedCount
+		<< ", dropped oldest " << droppedCount << ", overflows " << ring.GetOverflows() << ", blocks " << ring.GetBlocks() << std::endl;
+}
+
+int main()
+{
+	// Outlets are bounded to a small queue per consumer
+	Config config;
+	config.Set("outletMemoryLimit", std::to_string(outletMemoryLimitInMiB));
+	DeviceDescriptor device = MakeDeviceDescriptor<EpocPlus256Profile>();
+	CHECK(GetOutletMaxBuffered(CreateEEGStreamInfo("EmotivLSL_EEG", device, device.sampleRate), config) < 360);
+	std::shared_ptr<EEGChain> spChain = std::make_shared<EEGChain>(device, config, nullptr);
+
+	// Inlet which is opened but never read
+	std::vector<lsl::stream_info> results = lsl::resolve_stream("name", "EmotivLSL_EEG", 1, 10.0);
+	if (!CHECK(!results.empty()))
+	{
+		return TestResult("RingPolicyTest");
+	}
+	lsl::stream_inlet stalledInlet(results[0]);
+	stalledInlet.open_stream(10.0);
+	bool consumed = false;
+	for (int attempt = 0; attempt < 100 && !consumed; attempt++)
+	{
+		consumed = spChain->UpdateConsumers(lsl::local_clock());
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	}
+	CHECK(consumed);
+
+	// Both policies in turn, memory measured around them
+	size_t residentBefore = GetResidentMemory();
+	RunPolicy(RING_DROP_OLDEST, spChain);
+	RunPolicy(RING_BLOCK, spChain);
+	size_t residentAfter = GetResidentMemory();
+	if (residentBefore > 0 && residentAfter > 0)
+	{
+		size_t growth = residentAfter > residentBefore ? residentAfter - residentBefore : 0;
+		std::cout << "Resident memory grew by " << growth / (1024 * 1024) << " MiB" << std::endl;
+		CHECK(growth < maxResidentGrowthInMiB * 1024 * 1024);
+	}
+	return TestResult("RingPolicyTest");
+}
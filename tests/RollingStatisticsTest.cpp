@@ -0,0 +1,149 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Test of rolling statistics against a brute force window. Values arrive at
+// irregular times, drift and sometimes jump, and now and then are not finite.
+// After every value, count, mean, standard deviation, minimum, maximum and
+// both normalizations must match those computed over all values in the window.
+// Edge cases of empty windows, windows without spread and reset are checked.
+
+#include "RollingStatistics.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Defines
+const double window = 60.0; // default of performanceMetricsWindow
+const unsigned int valueCount = 20000;
+const double tolerance = 1e-9; // relative, as running updates round differently than sums
+
+// Whether values match within relative tolerance
+static bool Near(double actual, double expected)
+{
+	return std::abs(actual - expected) <= tolerance * std::max(1.0, std::abs(expected));
+}
+
+// Value with its time, as kept by brute force
+struct TimedValue
+{
+	double value;
+	double time;
+};
+
+// Compare statistics with those of all values in window
+static bool MatchesWindow(const RollingStatistics& rStatistics, const std::vector<TimedValue>& rWindow, double probe)
+{
+	if (rWindow.empty())
+	{
+		return CHECK(rStatistics.GetCount() == 0) && CHECK(std::isnan(rStatistics.GetZScore(probe)));
+	}
+	double sum = 0.0;
+	double minimum = std::numeric_limits<double>::max();
+	double maximum = -std::numeric_limits<double>::max();
+	for (const TimedValue& rEntry : rWindow)
+	{
+		sum += rEntry.value;
+		minimum = std::min(minimum, rEntry.value);
+		maximum = std::max(maximum, rEntry.value);
+	}
+	double mean = sum / rWindow.size();
+	double squaredDeviations = 0.0;
+	for (const TimedValue& rEntry : rWindow) { squaredDeviations += (rEntry.value - mean) * (rEntry.value - mean); }
+	double deviation = rWindow.size() > 1 ? std::sqrt(squaredDeviations / (rWindow.size() - 1)) : 0.0;
+	double zScore = deviation > 0.0 ? (probe - mean) / deviation : 0.0;
+	double scaled = maximum > minimum ? (probe - minimum) / (maximum - minimum) : 0.5;
+
+	// Deviations are checked against the spread, as they vanish when all values are close
+	double spreadTolerance = 1e-6 * std::max(1.0, maximum - minimum);
+	return CHECK(rStatistics.GetCount() == rWindow.size())
+		&& CHECK(Near(rStatistics.GetMean(), mean))
+		&& CHECK(std::abs(rStatistics.GetStandardDeviation() - deviation) <= spreadTolerance)
+		&& CHECK(rStatistics.GetMin() == minimum)
+		&& CHECK(rStatistics.GetMax() == maximum)
+		&& CHECK(deviation <= spreadTolerance || std::abs(rStatistics.GetZScore(probe) - zScore) <= 1e-6 * std::max(1.0, std::abs(zScore)))
+		&& CHECK(Near(rStatistics.GetWindowScaled(probe), scaled));
+}
+
+int main()
+{
+	// Empty window
+	RollingStatistics statistics(window);
+	CHECK(statistics.GetCount() == 0);
+	CHECK(std::isnan(statistics.GetZScore(1.0)));
+	CHECK(std::isnan(statistics.GetWindowScaled(1.0)));
+	CHECK(std::isnan(statistics.GetMin()) && std::isnan(statistics.GetMax()));
+
+	// Window without spread
+	statistics.Add(0.25, 0.0);
+	statistics.Add(0.25, 1.0);
+	CHECK(statistics.GetZScore(0.75) == 0.0);
+	CHECK(statistics.GetWindowScaled(0.75) == 0.5);
+	CHECK(std::isnan(statistics.GetZScore(std::numeric_limits<double>::quiet_NaN())));
+
+	// Values not finite are ignored
+	statistics.Add(std::numeric_limits<double>::quiet_NaN(), 2.0);
+	statistics.Add(std::numeric_limits<double>::infinity(), 2.0);
+	CHECK(statistics.GetCount() == 2);
+
+	// Value exactly one window old is kept, older ones leave
+	statistics.Add(0.5, window);
+	CHECK(statistics.GetCount() == 3);
+	statistics.Add(0.5, window + 0.5);
+	CHECK(statistics.GetCount() == 3);
+	CHECK(statistics.GetMin() == 0.25);
+	statistics.Add(0.5, window + 1.5);
+	CHECK(statistics.GetCount() == 3 && statistics.GetMin() == 0.5);
+
+	// Reset forgets everything
+	statistics.Reset();
+	CHECK(statistics.GetCount() == 0 && std::isnan(statistics.GetMin()));
+	CHECK(statistics.GetMean() == 0.0 && statistics.GetStandardDeviation() == 0.0);
+
+	// Irregular values against brute force, also across a gap longer than the window
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<double> interval(0.0, 1.0);
+	std::normal_distribution<double> noise(0.0, 0.05);
+	std::vector<TimedValue> brute;
+	double time = 1000.0;
+	double level = 0.5;
+	bool matching = true;
+	for (unsigned int valueIdx = 0; valueIdx < valueCount && matching; valueIdx++)
+	{
+		time += (valueIdx == valueCount / 2) ? 2.0 * window : interval(generator);
+		level += noise(generator);
+		if (valueIdx % 997 == 0) { level += 1.0; } // jump, e.g. another mental state
+		double value = (valueIdx % 101 == 0) ? std::numeric_limits<double>::quiet_NaN() : level;
+		statistics.Add(value, time);
+		if (std::isfinite(value))
+		{
+			brute.push_back({ value, time });
+		}
+		brute.erase(std::remove_if(brute.begin(), brute.end(), [time](const TimedValue& rEntry) { return rEntry.time < time - window; }), brute.end());
+		matching = MatchesWindow(statistics, brute, level + noise(generator));
+	}
+	CHECK(matching);
+	return TestResult("RollingStatisticsTest");
+}
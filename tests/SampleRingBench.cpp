@@ -0,0 +1,146 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Throughput of the ring between acquisition and publishing. One producer
+// hands blocks of a typical size to one consumer as fast as possible, with a
+// growing count of subscribers viewing them in place. Blocks per second and
+// the share of blocks refused to the producer or not viewed by subscribers
+// are reported.
+
+#include "SampleRing.h"
+#include "TestCheck.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+// Defines
+const unsigned int channelCount = 14;
+const unsigned int samplesPerBlock = 8; // 50 ms of EEG at 128 Hz rounded up to a few samples
+const size_t slotCount = 16;
+const unsigned int defaultBlockCount = 2000000;
+
+// Keeps the work of subscribers from being optimized away
+static volatile float sink = 0.f;
+
+// Run producer and consumer for count of blocks with count of subscribers. Returns blocks per second
+static double Run(unsigned int blockCount, unsigned int subscriberCount)
+{
+	SampleRing ring(slotCount, channelCount, samplesPerBlock);
+	ring.Prefault();
+	std::atomic<bool> producing{ true };
+	std::atomic<unsigned long long> viewed{ 0 };
+
+	// Subscribers only touch the first value of each block
+	std::vector<std::thread> subscribers;
+	for (unsigned int subscriberIdx = 0; subscriberIdx < subscriberCount; subscriberIdx++)
+	{
+		subscribers.push_back(std::thread([&ring, &producing, &viewed]()
+		{
+			SampleSubscription subscription(ring);
+			float sum = 0.f;
+			while (producing.load())
+			{
+				const SampleBlock* pBlock = subscription.Next();
+				if (pBlock)
+				{
+					sum += pBlock->values[0];
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+			subscription.Release();
+			sink = sum;
+			viewed += subscription.GetViewedCount();
+		}));
+	}
+
+	// Consumer releases blocks as soon as it sees them
+	unsigned long long consumed = 0;
+	std::thread consumer([&ring, &producing, &consumed]()
+	{
+		while (true)
+		{
+			bool running = producing.load();
+			size_t count = ring.Peek(4);
+			if (count == 0)
+			{
+				if (!running) { break; }
+				std::this_thread::yield();
+				continue;
+			}
+			consumed += count;
+			ring.Release(count);
+		}
+	});
+
+	// Producer fills and commits blocks, retrying refused ones
+	double startTime = SecondsSinceStart();
+	for (unsigned int blockIdx = 0; blockIdx < blockCount; )
+	{
+		if (ring.Reserve(1) == 1)
+		{
+			SampleBlock& rBlock = ring.Reserved(0);
+			rBlock.Resize(channelCount, samplesPerBlock);
+			rBlock.values[0] = (float)blockIdx;
+			rBlock.StampBackwards((double)blockIdx, 128.0);
+			ring.Commit(1);
+			blockIdx++;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	producing = false;
+	consumer.join();
+	double duration = SecondsSinceStart() - startTime;
+	for (auto& rSubscriber : subscribers)
+	{
+		rSubscriber.join();
+	}
+	CHECK(consumed == blockCount);
+
+	double blocksPerSecond = blockCount / duration;
+	std::cout << std::setw(12) << subscriberCount << std::setw(16) << (unsigned long long)blocksPerSecond
+		<< std::setw(14) << std::setprecision(3) << 1e9 / blocksPerSecond
+		<< std::setw(14) << 100.0 * ring.GetOverflows() / (ring.GetOverflows() + blockCount)
+		<< std::setw(14) << (subscriberCount > 0 ? 100.0 * (1.0 - (double)viewed.load() / ((double)subscriberCount * blockCount)) : 0.0) << std::endl;
+	return blocksPerSecond;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int blockCount = argc > 1 ? (unsigned int)std::atoi(argv[1]) : defaultBlockCount;
+	std::cout << "Blocks of " << channelCount << " channels by " << samplesPerBlock << " samples, "
+		<< blockCount << " per run, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+	std::cout << std::setw(12) << "subscribers" << std::setw(16) << "blocks/s" << std::setw(14) << "ns/block"
+		<< std::setw(14) << "refused %" << std::setw(14) << "unviewed %" << std::endl;
+	for (unsigned int subscriberCount : { 0u, 1u, 2u, 4u })
+	{
+		Run(blockCount, subscriberCount);
+	}
+	return TestResult("SampleRingBench");
+}
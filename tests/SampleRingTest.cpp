@@ -0,0 +1,241 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Stress test of the ring between acquisition and publishing. The ring has
+// exactly one producer and one consumer, so several rings run side by side,
+// each with its own producer, consumer and subscribers, all on their own
+// threads. Every block carries its sequence number in all of its values and
+// timestamps and a sample count derived from it, so the consumer can check
+// order and completeness and every subscriber can check that no view is torn,
+// also after holding it for a while.
+
+#include "SampleRing.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Defines
+const unsigned int ringCount = 3;
+const unsigned int subscribersPerRing = 3;
+const unsigned int blocksPerRing = 200000;
+const unsigned int channelCount = 14;
+const unsigned int maxSamplesPerBlock = 32;
+const size_t slotCount = 16;
+
+// Sample count of block with sequence number
+static unsigned int SampleCountOf(unsigned int sequence)
+{
+	return sequence % maxSamplesPerBlock + 1;
+}
+
+// Fill block with its sequence number
+static void FillBlock(SampleBlock& rBlock, unsigned int sequence)
+{
+	rBlock.Resize(channelCount, SampleCountOf(sequence));
+	for (float& rValue : rBlock.values) { rValue = (float)sequence; }
+	for (double& rTimestamp : rBlock.timestamps) { rTimestamp = (double)sequence; }
+}
+
+// Whether block is complete and all of it has the same sequence number. Returns it, if so
+static bool ReadBlock(const SampleBlock& rBlock, unsigned int& rSequence)
+{
+	if (rBlock.timestamps.empty() || rBlock.channelCount != channelCount)
+	{
+		return false;
+	}
+	rSequence = (unsigned int)rBlock.timestamps[0];
+	if (rBlock.SampleCount() != SampleCountOf(rSequence) || rBlock.values.size() != (size_t)channelCount * rBlock.SampleCount())
+	{
+		return false;
+	}
+	for (double timestamp : rBlock.timestamps)
+	{
+		if (timestamp != (double)rSequence) { return false; }
+	}
+	for (float value : rBlock.values)
+	{
+		if (value != (float)rSequence) { return false; }
+	}
+	return true;
+}
+
+// One ring with its threads. Policy of ring is chosen by index, so all of them are exercised
+struct RingUnderTest
+{
+	RingUnderTest(RingPolicy ringPolicy) : ring(slotCount, channelCount, maxSamplesPerBlock), policy(ringPolicy) {}
+
+	SampleRing ring;
+	RingPolicy policy;
+	std::atomic<bool> producing{ true };
+	unsigned int committedCount = 0; // written by producer, read after join
+	unsigned int consumedCount = 0; // written by consumer, read after join
+};
+
+// Produce blocks with increasing sequence numbers, those refused are not retried
+static void Produce(RingUnderTest& rTest)
+{
+	unsigned int sequence = 0;
+	for (unsigned int attempt = 0; attempt < blocksPerRing; attempt++)
+	{
+		size_t reserved = (rTest.policy == RING_BLOCK)
+			? rTest.ring.Reserve(1, std::chrono::milliseconds(1))
+			: rTest.ring.Reserve(1);
+		if (reserved == 1)
+		{
+			FillBlock(rTest.ring.Reserved(0), sequence++);
+			rTest.ring.Commit(1);
+		}
+		else
+		{
+			std::this_thread::yield(); // like acquisition, which waits for its next iteration
+		}
+	}
+	rTest.committedCount = sequence;
+	rTest.producing = false;
+}
+
+// Consume blocks, which must arrive in order. Only dropping oldest blocks may leave gaps
+static void Consume(RingUnderTest& rTest)
+{
+	unsigned int expected = 0;
+	while (true)
+	{
+		if (rTest.policy == RING_DROP_OLDEST)
+		{
+			rTest.ring.DropOldest(rTest.ring.GetCapacity() / 2);
+		}
+		bool producing = rTest.producing.load();
+		size_t count = rTest.ring.Peek(4);
+		if (count == 0)
+		{
+			if (!producing) { break; }
+			std::this_thread::yield();
+			continue;
+		}
+		for (size_t blockIdx = 0; blockIdx < count; blockIdx++)
+		{
+			unsigned int sequence = 0;
+			if (CHECK(ReadBlock(rTest.ring.Peeked(blockIdx), sequence)))
+			{
+				if (rTest.policy == RING_DROP_OLDEST)
+				{
+					CHECK(sequence >= expected);
+				}
+				else
+				{
+					CHECK(sequence == expected);
+				}
+				expected = sequence + 1;
+			}
+			rTest.consumedCount++;
+		}
+		rTest.ring.Release(count);
+	}
+}
+
+// View blocks in place. Views must never be torn, not even after holding them, and sequence numbers increase
+static void Subscribe(RingUnderTest& rTest, unsigned int subscriberIdx, uint64_t& rViewedCount, uint64_t& rLostCount)
+{
+	SampleSubscription subscription(rTest.ring);
+	bool first = true;
+	unsigned int previous = 0;
+	unsigned int viewIdx = 0;
+	while (true)
+	{
+		bool producing = rTest.producing.load();
+		const SampleBlock* pBlock = subscription.Next();
+		if (!pBlock)
+		{
+			if (!producing) { break; }
+			std::this_thread::yield();
+			continue;
+		}
+		unsigned int sequence = 0;
+		if (CHECK(ReadBlock(*pBlock, sequence)))
+		{
+			CHECK(first || sequence > previous);
+			first = false;
+			previous = sequence;
+		}
+
+		// Some views are held while the producer goes on, which must not write into them
+		if (++viewIdx % (7 + subscriberIdx) == 0)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+			unsigned int sequenceAfter = 0;
+			CHECK(ReadBlock(*pBlock, sequenceAfter) && sequenceAfter == sequence);
+		}
+	}
+	subscription.Release();
+	rViewedCount = subscription.GetViewedCount();
+	rLostCount = subscription.GetLostCount();
+}
+
+int main()
+{
+	// Rings live on the stack, as in acquisition, so their indices keep the alignment of cache lines
+	RingUnderTest dropNewestTest(RING_DROP_NEWEST);
+	RingUnderTest dropOldestTest(RING_DROP_OLDEST);
+	RingUnderTest blockTest(RING_BLOCK);
+	RingUnderTest* tests[ringCount] = { &dropNewestTest, &dropOldestTest, &blockTest };
+	std::vector<std::thread> threads;
+	std::vector<uint64_t> viewedCounts(ringCount * subscribersPerRing, 0);
+	std::vector<uint64_t> lostCounts(ringCount * subscribersPerRing, 0);
+
+	// Subscribers first, so they see the blocks from the start
+	for (unsigned int ringIdx = 0; ringIdx < ringCount; ringIdx++)
+	{
+		RingUnderTest& rTest = *tests[ringIdx];
+		for (unsigned int subscriberIdx = 0; subscriberIdx < subscribersPerRing; subscriberIdx++)
+		{
+			size_t countIdx = ringIdx * subscribersPerRing + subscriberIdx;
+			threads.push_back(std::thread(Subscribe, std::ref(rTest), subscriberIdx, std::ref(viewedCounts[countIdx]), std::ref(lostCounts[countIdx])));
+		}
+		threads.push_back(std::thread(Consume, std::ref(rTest)));
+		threads.push_back(std::thread(Produce, std::ref(rTest)));
+	}
+	for (auto& rThread : threads)
+	{
+		rThread.join();
+	}
+
+	// Every attempt is either committed or counted as overflow, every committed block consumed or dropped
+	for (unsigned int ringIdx = 0; ringIdx < ringCount; ringIdx++)
+	{
+		const RingUnderTest& rTest = *tests[ringIdx];
+		CHECK(rTest.committedCount + rTest.ring.GetOverflows() == blocksPerRing);
+		CHECK(rTest.consumedCount + rTest.ring.GetDroppedOldest() == rTest.committedCount);
+		CHECK(rTest.ring.GetFill() == 0);
+		for (unsigned int subscriberIdx = 0; subscriberIdx < subscribersPerRing; subscriberIdx++)
+		{
+			size_t countIdx = ringIdx * subscribersPerRing + subscriberIdx;
+			CHECK(viewedCounts[countIdx] > 0);
+			CHECK(viewedCounts[countIdx] + lostCounts[countIdx] == rTest.committedCount);
+		}
+		std::cout << "Ring " << ringIdx << ": committed " << rTest.committedCount << ", overflows " << rTest.ring.GetOverflows()
+			<< ", dropped oldest " << rTest.ring.GetDroppedOldest() << ", blocks " << rTest.ring.GetBlocks()
+			<< ", subscriber 0 viewed " << viewedCounts[ringIdx * subscribersPerRing] << ", lost " << lostCounts[ringIdx * subscribersPerRing] << std::endl;
+	}
+	return TestResult("SampleRingTest");
+}
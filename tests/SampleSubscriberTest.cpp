@@ -0,0 +1,206 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Test of subscribers handing blocks of the ring to a callback. The first
+// subscriber holds its first view for as long as the producer runs and is
+// slow afterwards, yet the producer must never be refused or wait beyond what
+// the consumer needs. Blocks carry their sequence number, so the callback can
+// check its views are intact and count the gaps it sees, which must match the
+// lost count. A callback throwing must end its subscriber only.
+
+#include "SampleSubscriber.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+// Defines
+const unsigned int blockCount = 100000;
+const unsigned int channelCount = 14;
+const unsigned int samplesPerBlock = 16;
+const size_t slotCount = 16;
+const std::chrono::seconds producerMaxWait(1); // only a held back producer waits that long
+const double catchUpTimeout = 10.0; // seconds subscribers may take to reach the newest block
+
+// Fill block with its sequence number
+static void FillBlock(SampleBlock& rBlock, unsigned int sequence)
+{
+	rBlock.Resize(channelCount, samplesPerBlock);
+	for (float& rValue : rBlock.values) { rValue = (float)sequence; }
+	for (double& rTimestamp : rBlock.timestamps) { rTimestamp = (double)sequence; }
+}
+
+// Whether block is complete and all of it has the same sequence number. Returns it, if so
+static bool ReadBlock(const SampleBlock& rBlock, unsigned int& rSequence)
+{
+	if (rBlock.SampleCount() != samplesPerBlock || rBlock.values.size() != (size_t)channelCount * samplesPerBlock)
+	{
+		return false;
+	}
+	rSequence = (unsigned int)rBlock.timestamps[0];
+	for (double timestamp : rBlock.timestamps)
+	{
+		if (timestamp != (double)rSequence) { return false; }
+	}
+	for (float value : rBlock.values)
+	{
+		if (value != (float)rSequence) { return false; }
+	}
+	return true;
+}
+
+// What the callback of a subscriber has seen, only touched by its thread until it is destroyed
+struct SeenBlocks
+{
+	unsigned int calledCount = 0;
+	unsigned int expected = 0; // next sequence number without gap
+	unsigned long long gapCount = 0; // blocks skipped between calls
+};
+
+// Account for block in callback, checking it is intact and in order
+static void See(SeenBlocks& rSeen, const SampleBlock& rBlock)
+{
+	unsigned int sequence = 0;
+	if (CHECK(ReadBlock(rBlock, sequence)) && CHECK(sequence >= rSeen.expected))
+	{
+		rSeen.gapCount += sequence - rSeen.expected;
+		rSeen.expected = sequence + 1;
+	}
+	rSeen.calledCount++;
+}
+
+// Wait until subscriber has viewed or lost all committed blocks
+static bool CatchUp(const SampleSubscriber& rSubscriber, unsigned long long committedCount)
+{
+	double deadline = SecondsSinceStart() + catchUpTimeout;
+	while (rSubscriber.GetViewedCount() + rSubscriber.GetLostCount() < committedCount && SecondsSinceStart() < deadline)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return rSubscriber.GetViewedCount() + rSubscriber.GetLostCount() == committedCount;
+}
+
+int main()
+{
+	SampleRing ring(slotCount, channelCount, samplesPerBlock);
+	std::atomic<bool> producing{ true };
+	std::atomic<bool> holding{ true };
+
+	// Consumer drains the ring like publishing and finds every block intact and in order
+	unsigned int consumedCount = 0;
+	std::thread consumer([&]()
+	{
+		while (true)
+		{
+			bool stillProducing = producing.load();
+			size_t count = ring.Peek(4);
+			if (count == 0)
+			{
+				if (!stillProducing) { break; }
+				std::this_thread::yield();
+				continue;
+			}
+			for (size_t blockIdx = 0; blockIdx < count; blockIdx++)
+			{
+				unsigned int sequence = 0;
+				CHECK(ReadBlock(ring.Peeked(blockIdx), sequence) && sequence == consumedCount);
+				consumedCount++;
+			}
+			ring.Release(count);
+		}
+	});
+
+	// Slow subscriber holds its first view until producing ends, then sleeps on every block and checks the view again
+	SeenBlocks slowSeen;
+	std::unique_ptr<SampleSubscriber> upSlowSubscriber(new SampleSubscriber(ring, [&](const SampleBlock& rBlock)
+	{
+		See(slowSeen, rBlock);
+		do
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		} while (holding.load());
+		unsigned int sequenceBefore = slowSeen.expected - 1;
+		unsigned int sequenceAfter = 0;
+		CHECK(ReadBlock(rBlock, sequenceAfter) && sequenceAfter == sequenceBefore);
+	}));
+
+	// Fast subscriber sees what it can
+	SeenBlocks fastSeen;
+	std::unique_ptr<SampleSubscriber> upFastSubscriber(new SampleSubscriber(ring, [&](const SampleBlock& rBlock)
+	{
+		See(fastSeen, rBlock);
+	}));
+
+	// Throwing subscriber ends on its third block, others go on
+	SampleSubscriber throwingSubscriber(ring, [](const SampleBlock& rBlock)
+	{
+		if (rBlock.timestamps[0] >= 2.0)
+		{
+			throw std::runtime_error("callback gave up");
+		}
+	});
+
+	// Producer waits for the consumer only, subscribers never hold it back
+	for (unsigned int sequence = 0; sequence < blockCount; sequence++)
+	{
+		if (CHECK(ring.Reserve(1, producerMaxWait) == 1))
+		{
+			FillBlock(ring.Reserved(0), sequence);
+			ring.Commit(1);
+		}
+	}
+	producing = false;
+	consumer.join();
+	CHECK(ring.GetOverflows() == 0);
+	CHECK(consumedCount == blockCount);
+
+	// Slow subscriber is still on its first block, and lost the others when it catches up
+	CHECK(upSlowSubscriber->GetViewedCount() == 1);
+	holding = false;
+	CHECK(CatchUp(*upSlowSubscriber, blockCount));
+	CHECK(CatchUp(*upFastSubscriber, blockCount));
+	CHECK(upSlowSubscriber->GetLostCount() > 0);
+
+	// Thrower ended on its own, with its message kept
+	CHECK(throwingSubscriber.HasFailed());
+	CHECK(throwingSubscriber.GetError() == "callback gave up");
+	CHECK(!upSlowSubscriber->HasFailed() && !upFastSubscriber->HasFailed());
+
+	// Counts are final once caught up. Stopping the threads lets the last callbacks return
+	uint64_t slowViewed = upSlowSubscriber->GetViewedCount();
+	uint64_t slowLost = upSlowSubscriber->GetLostCount();
+	uint64_t fastViewed = upFastSubscriber->GetViewedCount();
+	uint64_t fastLost = upFastSubscriber->GetLostCount();
+	upSlowSubscriber.reset();
+	upFastSubscriber.reset();
+	std::cout << "Slow subscriber viewed " << slowViewed << ", lost " << slowLost
+		<< "; fast subscriber viewed " << fastViewed << ", lost " << fastLost << std::endl;
+
+	// Lost counts match gaps seen by callbacks, including those after their last block
+	CHECK(slowSeen.calledCount == slowViewed);
+	CHECK(fastSeen.calledCount == fastViewed);
+	CHECK(slowSeen.gapCount + (blockCount - slowSeen.expected) == slowLost);
+	CHECK(fastSeen.gapCount + (blockCount - fastSeen.expected) == fastLost);
+	return TestResult("SampleSubscriberTest");
+}
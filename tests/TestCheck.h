@@ -0,0 +1,77 @@
+//	The MIT License (MIT)
+//
+//	Copyright(c) 2016 Raphael Menges
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a copy
+//	of this software and associated documentation files(the "Software"), to deal
+//	in the Software without restriction, including without limitation the rights
+//	to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//	copies of the Software, and to permit persons to whom the Software is
+//	furnished to do so, subject to the following conditions :
+//
+//	The above copyright notice and this permission notice shall be included in all
+//	copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//	SOFTWARE.
+
+// Minimal checks shared by the tests. A failing check prints its location and
+// condition and lets the test exit with a non-zero code, as CTest expects.
+// Checks may be called from several threads.
+
+#ifndef TEST_CHECK_H_
+#define TEST_CHECK_H_
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+
+// Count of failed checks of the test
+inline std::atomic<unsigned int>& FailedCheckCount()
+{
+	static std::atomic<unsigned int> count{ 0 };
+	return count;
+}
+
+// Count failure and print it. Returns condition
+inline bool CheckCondition(bool condition, const char* pCondition, const char* pFile, int line)
+{
+	if (!condition)
+	{
+		static std::mutex outputMutex;
+		std::lock_guard<std::mutex> lock(outputMutex);
+		std::cerr << pFile << ":" << line << ": check failed: " << pCondition << std::endl;
+		FailedCheckCount()++;
+	}
+	return condition;
+}
+
+#define CHECK(condition) CheckCondition((condition), #condition, __FILE__, __LINE__)
+
+// Exit code of the test, after telling how it went
+inline int TestResult(const char* pName)
+{
+	unsigned int failedCount = FailedCheckCount().load();
+	if (failedCount > 0)
+	{
+		std::cerr << pName << ": " << failedCount << " checks failed" << std::endl;
+		return 1;
+	}
+	std::cout << pName << ": passed" << std::endl;
+	return 0;
+}
+
+// Seconds since first call, for benchmarks
+inline double SecondsSinceStart()
+{
+	static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif // TEST_CHECK_H_